@@ -175,7 +175,8 @@ private:
 
 // TODO: parameter "system" is unused
 MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _commandsHead(0), _commandsCount(0) {
 
 	assert(sampleRate > 0);
 
@@ -221,6 +222,73 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		*handle = chanHandle;
 }
 
+void MixerImpl::queueCommand(ChannelCommand::Type type, SoundHandle handle, int value) {
+	{
+		Common::StackLock lock(_commandMutex);
+
+		// Replace a change of the same setting still waiting in the queue
+		for (uint i = 0; i < _commandsCount; i++) {
+			ChannelCommand &command = _commands[(_commandsHead + i) % NUM_COMMANDS];
+			if (command.type == type && command.handle._val == handle._val) {
+				command.value = value;
+				return;
+			}
+		}
+
+		if (_commandsCount < NUM_COMMANDS) {
+			ChannelCommand &command = _commands[(_commandsHead + _commandsCount) % NUM_COMMANDS];
+			command.type = type;
+			command.handle = handle;
+			command.value = value;
+			_commandsCount++;
+			return;
+		}
+	}
+
+	// The queue is full, wait for the mixer and apply the change directly
+	Common::StackLock lock(_mutex);
+	applyCommands();
+
+	const int index = handle._val % NUM_CHANNELS;
+	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+		return;
+
+	if (type == ChannelCommand::kSetVolume)
+		_channels[index]->setVolume(value);
+	else
+		_channels[index]->setBalance(value);
+}
+
+bool MixerImpl::findQueuedCommand(ChannelCommand::Type type, SoundHandle handle, int &value) {
+	Common::StackLock lock(_commandMutex);
+	for (uint i = 0; i < _commandsCount; i++) {
+		const ChannelCommand &command = _commands[(_commandsHead + i) % NUM_COMMANDS];
+		if (command.type == type && command.handle._val == handle._val) {
+			value = command.value;
+			return true;
+		}
+	}
+	return false;
+}
+
+void MixerImpl::applyCommands() {
+	Common::StackLock lock(_commandMutex);
+	for (; _commandsCount > 0; _commandsCount--) {
+		const ChannelCommand &command = _commands[_commandsHead];
+		_commandsHead = (_commandsHead + 1) % NUM_COMMANDS;
+
+		// Simply ignore the changes for sounds that already terminated
+		const int index = command.handle._val % NUM_CHANNELS;
+		if (!_channels[index] || _channels[index]->getHandle()._val != command.handle._val)
+			continue;
+
+		if (command.type == ChannelCommand::kSetVolume)
+			_channels[index]->setVolume(command.value);
+		else
+			_channels[index]->setBalance(command.value);
+	}
+}
+
 void MixerImpl::playStream(
 			SoundType type,
 			SoundHandle *handle,
@@ -271,6 +339,8 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 
 	Common::StackLock lock(_mutex);
 
+	applyCommands();
+
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
 	assert(len % 4 == 0);
@@ -348,16 +418,14 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setVolume(volume);
+	queueCommand(ChannelCommand::kSetVolume, handle, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
+	int volume;
+	if (findQueuedCommand(ChannelCommand::kSetVolume, handle, volume))
+		return volume;
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -366,16 +434,14 @@ byte MixerImpl::getChannelVolume(SoundHandle handle) {
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setBalance(balance);
+	queueCommand(ChannelCommand::kSetBalance, handle, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
+	int balance;
+	if (findQueuedCommand(ChannelCommand::kSetBalance, handle, balance))
+		return balance;
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -51,11 +51,36 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32 // ResidualVM specific
+		NUM_CHANNELS = 32, // ResidualVM specific
+		NUM_COMMANDS = 64
 	};
 
 	Common::Mutex _mutex;
 
+	/**
+	 * A channel volume or balance change waiting to be applied.
+	 *
+	 * Engines change these settings many times per frame, so they are
+	 * queued and applied the next time the channels are accessed by
+	 * the mixer, instead of waiting for the mixing to be done.
+	 */
+	struct ChannelCommand {
+		enum Type {
+			kSetVolume,
+			kSetBalance
+		};
+
+		Type type;
+		SoundHandle handle;
+		int value;
+	};
+
+	// Guards the command queue only, and is never held while mixing
+	Common::Mutex _commandMutex;
+	ChannelCommand _commands[NUM_COMMANDS];
+	uint _commandsHead;
+	uint _commandsCount;
+
 	const uint _sampleRate;
 	bool _mixerReady;
 	uint32 _handleSeed;
@@ -121,6 +146,11 @@ public:
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+	void queueCommand(ChannelCommand::Type type, SoundHandle handle, int value);
+	bool findQueuedCommand(ChannelCommand::Type type, SoundHandle handle, int &value);
+	/** Applies the queued commands, _mutex must be held. */
+	void applyCommands();
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
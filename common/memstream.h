@@ -23,6 +23,7 @@
 #ifndef COMMON_MEMSTREAM_H
 #define COMMON_MEMSTREAM_H
 
+#include "common/ptr.h"
 #include "common/stream.h"
 #include "common/types.h"
 
@@ -73,6 +74,21 @@ public:
 };
 
 
+/**
+ * A MemoryReadStream over a range of a reference counted memory block.
+ * Any number of these streams can view the same block without copying it,
+ * and the block stays alive until the last reference to it is gone.
+ */
+class SharedMemoryReadStream : public MemoryReadStream {
+private:
+	SharedPtr<byte> _block;
+
+public:
+	SharedMemoryReadStream(const SharedPtr<byte> &block, uint32 offset, uint32 dataSize) :
+		MemoryReadStream(block.get() + offset, dataSize),
+		_block(block) {}
+};
+
 /**
  * This is a MemoryReadStream subclass which adds non-endian
  * read methods whose endianness is set on the stream creation.
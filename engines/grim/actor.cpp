@@ -600,6 +600,52 @@ void Actor::turnTo(const Math::Angle &pitchParam, const Math::Angle &yawParam, c
 		_turning = false;
 }
 
+// Entry of the path finding open set, a binary heap on the estimated length
+struct OpenPathNode {
+	float estimate;
+	int node;
+	uint entry;
+};
+
+static void pushOpenPathNode(Common::Array<OpenPathNode> &heap, float estimate, int node, uint entry) {
+	uint i = heap.size();
+	heap.push_back(OpenPathNode());
+	while (i > 0) {
+		uint parent = (i - 1) / 2;
+		if (heap[parent].estimate <= estimate)
+			break;
+		heap[i] = heap[parent];
+		i = parent;
+	}
+	heap[i].estimate = estimate;
+	heap[i].node = node;
+	heap[i].entry = entry;
+}
+
+static OpenPathNode popOpenPathNode(Common::Array<OpenPathNode> &heap) {
+	OpenPathNode top = heap[0];
+	OpenPathNode last = heap.back();
+	heap.pop_back();
+
+	uint size = heap.size();
+	uint i = 0;
+	while (size > 0) {
+		uint child = 2 * i + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && heap[child + 1].estimate < heap[child].estimate)
+			child++;
+		if (last.estimate <= heap[child].estimate)
+			break;
+		heap[i] = heap[child];
+		i = child;
+	}
+	if (size > 0)
+		heap[i] = last;
+
+	return top;
+}
+
 void Actor::walkTo(const Math::Vector3d &p) {
 	if (p == _pos)
 		_walking = false;
@@ -614,43 +660,47 @@ void Actor::walkTo(const Math::Vector3d &p) {
 			Set *currSet = g_grim->getCurrSet();
 			currSet->findClosestSector(p, nullptr, &_destPos);
 
-			Common::List<PathNode *> openList;
-			Common::List<PathNode *> closedList;
-
-			PathNode *start = new PathNode;
-			start->parent = nullptr;
-			start->pos = _pos;
-			start->dist = 0.f;
-			start->cost = 0.f;
-			openList.push_back(start);
-			currSet->findClosestSector(_pos, &start->sect, nullptr);
-
-			Common::List<Sector *> sectors;
-			for (int i = 0; i < currSet->getSectorCount(); ++i) {
-				Sector *s = currSet->getSectorBase(i);
-				int type = s->getType();
-				if ((type == Sector::WalkType || type == Sector::HotType || type == Sector::FunnelType) && s->isVisible()) {
-					sectors.push_back(s);
-				}
+			Sector *startSector;
+			currSet->findClosestSector(_pos, &startSector, nullptr);
+			int startIndex = currSet->getSectorIndex(startSector);
+
+			// One node per sector of the set, the open set being a binary
+			// heap of indices in this array.
+			Common::Array<PathNode> nodes;
+			nodes.resize(currSet->getSectorCount());
+			for (uint i = 0; i < nodes.size(); ++i) {
+				nodes[i].sect = currSet->getSectorBase(i);
+				nodes[i].parent = nullptr;
+				nodes[i].open = false;
+				nodes[i].closed = false;
 			}
 
-			do {
-				PathNode *node = nullptr;
-				float cost = -1.f;
-				for (Common::List<PathNode *>::iterator j = openList.begin(); j != openList.end(); ++j) {
-					PathNode *n = *j;
-					float c = n->dist + n->cost;
-					if (cost < 0.f || c < cost) {
-						cost = c;
-						node = n;
-					}
-				}
-				closedList.push_back(node);
-				openList.remove(node);
+			Common::Array<OpenPathNode> openList;
+			uint heapEntries = 0;
+			if (startIndex >= 0) {
+				PathNode *start = &nodes[startIndex];
+				start->pos = _pos;
+				start->dist = 0.f;
+				start->cost = 0.f;
+				start->heapEntry = heapEntries++;
+				start->open = true;
+				pushOpenPathNode(openList, 0.f, startIndex, start->heapEntry);
+			}
+
+			while (!openList.empty()) {
+				OpenPathNode top = popOpenPathNode(openList);
+				PathNode *node = &nodes[top.node];
+				// Nodes whose cost got lowered after being pushed are in
+				// the heap more than once, skip all but the latest entry.
+				if (node->closed || top.entry != node->heapEntry)
+					continue;
+
+				node->open = false;
+				node->closed = true;
 				Sector *sector = node->sect;
 
-				if (sector && sector->isPointInSector(_destPos)) {
-					PathNode *n = closedList.back();
+				if (sector->isPointInSector(_destPos)) {
+					PathNode *n = node;
 					// Don't put the start position in the list, or else
 					// the first angle calculated in updateWalk() will be
 					// meaningless. The only node without parent is the start
@@ -664,22 +714,15 @@ void Actor::walkTo(const Math::Vector3d &p) {
 					break;
 				}
 
-				for (Common::List<Sector *>::iterator i = sectors.begin(); i != sectors.end(); ++i) {
-					Sector *s = *i;
-					bool inClosed = false;
-					for (Common::List<PathNode *>::iterator j = closedList.begin(); j != closedList.end(); ++j) {
-						if ((*j)->sect == s) {
-							inClosed = true;
-							break;
-						}
-					}
-					if (inClosed)
+				const Common::Array<Set::SectorLink> &links = currSet->getSectorLinks(top.node);
+				for (uint i = 0; i < links.size(); ++i) {
+					PathNode *n = &nodes[links[i].sector];
+					Sector *s = n->sect;
+					if (n->closed || !s->isVisible())
 						continue;
 
 					// Get "bridges" from the current sector to the other.
-					Common::List<Math::Line3d> bridges = sector->getBridgesTo(s);
-					if (bridges.empty())
-						continue; // The sectors are not adjacent.
+					const Common::Array<Math::Line3d> &bridges = links[i].bridges;
 
 					Math::Vector3d closestPoint;
 					if (g_grim->getGameType() == GType_GRIM)
@@ -691,8 +734,8 @@ void Actor::walkTo(const Math::Vector3d &p) {
 					Math::Line3d l(node->pos, closestPoint);
 
 					// Pick a point on the boundary of the two sectors to walk towards.
-					while (!bridges.empty()) {
-						Math::Line3d bridge = bridges.back();
+					for (int j = bridges.size() - 1; j >= 0; --j) {
+						Math::Line3d bridge = bridges[j];
 						Math::Vector3d pos;
 						const bool useXZ = (g_grim->getGameType() == GType_MONKEY4);
 
@@ -710,42 +753,21 @@ void Actor::walkTo(const Math::Vector3d &p) {
 							bestDist = dist;
 							best = pos;
 						}
-						bridges.pop_back();
 					}
 					best = handleCollisionTo(node->pos, best);
 
-					PathNode *n = nullptr;
-					for (Common::List<PathNode *>::iterator j = openList.begin(); j != openList.end(); ++j) {
-						if ((*j)->sect == s) {
-							n = *j;
-							break;
-						}
-					}
-					if (n) {
-						float newCost = node->cost + (best - node->pos).getMagnitude();
-						if (newCost < n->cost) {
-							n->cost = newCost;
-							n->parent = node;
-							n->pos = best;
-							n->dist = (n->pos - _destPos).getMagnitude();
-						}
-					} else {
-						n = new PathNode;
-						n->parent = node;
-						n->sect = s;
-						n->pos = best;
-						n->dist = (n->pos - _destPos).getMagnitude();
-						n->cost = node->cost + (n->pos - node->pos).getMagnitude();
-						openList.push_back(n);
-					}
-				}
-			} while (!openList.empty());
+					float newCost = node->cost + (best - node->pos).getMagnitude();
+					if (n->open && newCost >= n->cost)
+						continue;
 
-			for (Common::List<PathNode *>::iterator j = closedList.begin(); j != closedList.end(); ++j) {
-				delete *j;
-			}
-			for (Common::List<PathNode *>::iterator j = openList.begin(); j != openList.end(); ++j) {
-				delete *j;
+					n->parent = node;
+					n->pos = best;
+					n->dist = (n->pos - _destPos).getMagnitude();
+					n->cost = newCost;
+					n->heapEntry = heapEntries++;
+					n->open = true;
+					pushOpenPathNode(openList, n->dist + n->cost, links[i].sector, n->heapEntry);
+				}
 			}
 
 			if (!pathFound) {
@@ -1894,8 +1916,13 @@ void Actor::clearShadowPlane(int i) {
 	shadow->active = false;
 	shadow->dontNegate = false;
 
-	// TODO: Clean up the userData properly
-	shadow->userData = nullptr;
+	g_driver->destroyShadow(shadow);
+}
+
+void Actor::releaseShadowData() {
+	for (int i = 0; i < MAX_SHADOWS; i++) {
+		g_driver->destroyShadow(&_shadowArray[i]);
+	}
 }
 
 void Actor::putInSet(const Common::String &set) {
@@ -482,6 +482,7 @@ public:
 	void setShadowPlane(const char *name);
 	void addShadowPlane(const char *name);
 	void clearShadowPlanes();
+	void releaseShadowData();
 	void clearShadowPlane(int i);
 	void setShadowValid(int);
 	void setActivateShadow(int, bool);
@@ -551,6 +552,7 @@ public:
 	void restoreCleanBuffer();
 	void drawToCleanBuffer();
 	void clearCleanBuffer();
+	bool hasCleanBuffer() const { return _cleanBuffer != 0; }
 
 	bool isTalkingForeground() const;
 
@@ -691,6 +693,9 @@ private:
 		Math::Vector3d pos;
 		float dist;
 		float cost;
+		uint heapEntry;
+		bool open;
+		bool closed;
 	};
 	Common::List<Math::Vector3d> _path;
 
@@ -109,6 +109,47 @@ void BitmapData::load() {
 	_loaded = true;
 }
 
+bool BitmapData::isFromFile() const {
+	return _bitmaps && _bitmaps->contains(_fname) && (*_bitmaps)[_fname] == this;
+}
+
+void BitmapData::releaseDriverData() {
+	if (!_loaded)
+		return;
+
+	if (_texIds) {
+		g_driver->destroyBitmap(this);
+		_texIds = nullptr;
+		_numTex = 0;
+	}
+
+	if (isFromFile()) {
+		bool keepData = _keepData;
+		_keepData = false;
+		freeData();
+		_keepData = keepData;
+
+		delete[] _texc;
+		delete[] _layers;
+		delete[] _verts;
+		_texc = nullptr;
+		_layers = nullptr;
+		_verts = nullptr;
+		_loaded = false;
+	}
+}
+
+void BitmapData::createDriverData() {
+	if (isFromFile()) {
+		load();
+	} else if (_loaded && !_texIds && _data) {
+		// Screenshots are kept as RGB565, undo the conversion of the old driver
+		if (_bpp == 16)
+			convertToColorFormat(Graphics::createPixelFormat<565>());
+		g_driver->createBitmap(this);
+	}
+}
+
 bool BitmapData::loadGrimBm(Common::SeekableReadStream *data) {
 	uint32 tag2 = data->readUint32BE();
 	if (tag2 != (MKTAG('F','\0','\0','\0')))
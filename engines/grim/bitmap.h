@@ -59,6 +59,14 @@ public:
 
 	void load();
 
+	/**
+	 * Release the data the driver created for this bitmap, so that the
+	 * driver can be replaced. Bitmaps loaded from a file are read again by
+	 * createDriverData(), since the driver converts their pixels in place.
+	 */
+	void releaseDriverData();
+	void createDriverData();
+
 	/**
 	 * Loads an EMI TILE-bitmap.
 	 *
@@ -70,6 +78,7 @@ public:
 	bool loadTGA(Common::SeekableReadStream *data);
 
 	static BitmapData *getBitmapData(const Common::String &fname);
+	bool isFromFile() const;
 	static Common::HashMap<Common::String, BitmapData *> *_bitmaps;
 
 	const Graphics::PixelBuffer &getImageData(int num) const;
@@ -20,11 +20,16 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "common/config-manager.h"
 
 #include "engines/grim/debugger.h"
 #include "engines/grim/md5check.h"
 #include "engines/grim/grim.h"
+#include "engines/grim/resource.h"
+#include "engines/grim/emi/emi.h"
+#include "engines/grim/lua/lgc.h"
+#include "engines/grim/lua/lua.h"
 
 namespace Grim {
 
@@ -37,6 +42,11 @@ Debugger::Debugger() :
 	registerCmd("swap_renderer", WRAP_METHOD(Debugger, cmd_swap_renderer));
 	registerCmd("save", WRAP_METHOD(Debugger, cmd_save));
 	registerCmd("load", WRAP_METHOD(Debugger, cmd_load));
+	registerCmd("resource_cache", WRAP_METHOD(Debugger, cmd_resource_cache));
+	registerCmd("model_culling", WRAP_METHOD(Debugger, cmd_model_culling));
+	registerCmd("lua_gc", WRAP_METHOD(Debugger, cmd_lua_gc));
+	registerCmd("lua_tasks", WRAP_METHOD(Debugger, cmd_lua_tasks));
+	registerCmd("lua_profile", WRAP_METHOD(Debugger, cmd_lua_profile));
 }
 
 Debugger::~Debugger() {
@@ -115,4 +125,108 @@ bool Debugger::cmd_load(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmd_resource_cache(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Usage: resource_cache [<budget in KB>]\n");
+		return true;
+	}
+	if (argc == 2) {
+		char *end;
+		long budget = strtol(argv[1], &end, 10);
+		// The budget is stored in bytes, so it must be positive and fit in 32 bits once scaled.
+		if (end == argv[1] || *end != '\0' || budget <= 0 || (unsigned long)budget > 0xFFFFFFFFUL / 1024) {
+			debugPrintf("Usage: resource_cache [<budget in KB>]\n");
+			debugPrintf("The budget must be a positive number of kilobytes\n");
+			return true;
+		}
+		g_resourceloader->setCacheBudget((uint32)budget * 1024);
+	}
+
+	ResourceLoader::CacheStats stats = g_resourceloader->getCacheStats();
+	debugPrintf("Entries: %d, size: %d KB, budget: %d KB\n", stats.entries, stats.memorySize / 1024, stats.budget / 1024);
+	debugPrintf("Hits: %d, misses: %d\n", stats.hits, stats.misses);
+	debugPrintf("Evictions: %d (%d KB)\n", stats.evictions, stats.evictedBytes / 1024);
+	return true;
+}
+
+bool Debugger::cmd_model_culling(int argc, const char **argv) {
+	if (!g_emi) {
+		debugPrintf("Model culling statistics are only available in EMI\n");
+		return true;
+	}
+
+	debugPrintf("Models drawn: %d, culled: %d\n", g_emi->getLastFrameDrawnModels(), g_emi->getLastFrameCulledModels());
+	return true;
+}
+
+bool Debugger::cmd_lua_gc(int argc, const char **argv) {
+	const GCStats &stats = luaC_getstats();
+	debugPrintf("Cycles: %d, steps: %d, work: %d\n", stats.cycles, stats.steps, stats.work);
+	debugPrintf("Last pause: %u ms, longest pause: %u ms\n", stats.lastPause, stats.maxPause);
+	return true;
+}
+
+bool Debugger::cmd_lua_tasks(int argc, const char **argv) {
+	Common::Array<lua_TaskInfo> tasks;
+	lua_gettaskinfo(tasks);
+
+	debugPrintf("   id   runs  total ms  max ms  state     script\n");
+	for (uint i = 0; i < tasks.size(); i++) {
+		const lua_TaskInfo &t = tasks[i];
+		Common::String status;
+		if (t.paused)
+			status = "paused";
+		else if (t.sleepFor > 0)
+			status = Common::String::format("sleep %d", t.sleepFor);
+		else
+			status = "ready";
+		debugPrintf("%5u %6d %9u %7u  %-9s %s\n", t.id, t.runs, t.runTime, t.maxRunTime, status.c_str(), t.name.c_str());
+	}
+	return true;
+}
+
+static bool moreInstructions(const lua_FunctionProfile &a, const lua_FunctionProfile &b) {
+	return a.instructions > b.instructions;
+}
+
+static bool moreRuns(const lua_OpcodeProfile &a, const lua_OpcodeProfile &b) {
+	return a.count > b.count;
+}
+
+bool Debugger::cmd_lua_profile(int argc, const char **argv) {
+	if (argc > 1) {
+		Common::String cmd = argv[1];
+		if (cmd == "on") {
+			lua_setprofiling(true);
+		} else if (cmd == "off") {
+			lua_setprofiling(false);
+		} else if (cmd == "reset") {
+			lua_resetprofile();
+		} else {
+			debugPrintf("Usage: lua_profile [on|off|reset]\n");
+			debugPrintf("Without arguments, prints the functions and opcodes that ran the most.\n");
+			return true;
+		}
+		debugPrintf("Profiling is %s\n", lua_isprofiling() ? "on" : "off");
+		return true;
+	}
+
+	Common::Array<lua_FunctionProfile> functions;
+	Common::Array<lua_OpcodeProfile> opcodes;
+	lua_getprofile(functions, opcodes);
+	Common::sort(functions.begin(), functions.end(), moreInstructions);
+	Common::sort(opcodes.begin(), opcodes.end(), moreRuns);
+
+	debugPrintf("Profiling is %s\n", lua_isprofiling() ? "on" : "off");
+	debugPrintf("instructions    calls   ms  function\n");
+	for (uint i = 0; i < functions.size() && i < 20; i++) {
+		const lua_FunctionProfile &f = functions[i];
+		debugPrintf("%12u %8u %4u  %s\n", f.instructions, f.calls, f.msecs, f.name.c_str());
+	}
+	debugPrintf("\n   count  opcode\n");
+	for (uint i = 0; i < opcodes.size() && i < 10 && opcodes[i].count; i++)
+		debugPrintf("%8u  %s\n", opcodes[i].count, opcodes[i].name);
+	return true;
+}
+
 }
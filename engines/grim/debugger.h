@@ -40,6 +40,11 @@ public:
 	bool cmd_swap_renderer(int argc, const char **argv);
 	bool cmd_save(int argc, const char **argv);
 	bool cmd_load(int argc, const char **argv);
+	bool cmd_resource_cache(int argc, const char **argv);
+	bool cmd_model_culling(int argc, const char **argv);
+	bool cmd_lua_gc(int argc, const char **argv);
+	bool cmd_lua_tasks(int argc, const char **argv);
+	bool cmd_lua_profile(int argc, const char **argv);
 };
 
 }
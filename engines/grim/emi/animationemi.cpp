@@ -30,7 +30,7 @@
 namespace Grim {
 
 AnimationEmi::AnimationEmi(const Common::String &filename, Common::SeekableReadStream *data) :
-		_name(""), _duration(0.0f), _numBones(0), _bones(nullptr) {
+		_name(""), _duration(0.0f), _numBones(0), _bones(nullptr), _keyTimes(nullptr) {
 	_fname = filename;
 	loadAnimation(data);
 }
@@ -49,14 +49,28 @@ void AnimationEmi::loadAnimation(Common::SeekableReadStream *data) {
 	_numBones = data->readUint32LE();
 
 	_bones = new Bone[_numBones];
+	int numKeys = 0;
 	for (int i = 0; i < _numBones; i++) {
 		_bones[i].loadBinary(data);
+		numKeys += _bones[i]._count;
+	}
+
+	_keyTimes = new float[numKeys];
+	float *times = _keyTimes;
+	for (int i = 0; i < _numBones; i++) {
+		Bone &bone = _bones[i];
+		for (int j = 0; j < bone._count; j++) {
+			times[j] = bone._rotations ? bone._rotations[j]._time : bone._translations[j]._time;
+		}
+		bone._times = times;
+		times += bone._count;
 	}
 }
 
 AnimationEmi::~AnimationEmi() {
 	g_resourceloader->uncacheAnimationEmi(this);
 	delete[] _bones;
+	delete[] _keyTimes;
 }
 
 void Bone::loadBinary(Common::SeekableReadStream *data) {
@@ -101,15 +115,21 @@ Bone::~Bone() {
 AnimationStateEmi::AnimationStateEmi(const Common::String &anim) :
 		_skel(nullptr), _looping(false), _active(false),
 		_fadeMode(Animation::None), _fade(1.0f), _fadeLength(0), _time(0), _startFade(1.0f),
-		_boneJoints(nullptr) {
+		_boneJoints(nullptr), _keyCursors(nullptr), _cursorTime(0) {
 	_anim = g_resourceloader->getAnimationEmi(anim);
-	if (_anim)
+	if (_anim) {
 		_boneJoints = new int[_anim->_numBones];
+		_keyCursors = new int[_anim->_numBones];
+		for (int i = 0; i < _anim->_numBones; ++i) {
+			_keyCursors[i] = 0;
+		}
+	}
 }
 
 AnimationStateEmi::~AnimationStateEmi() {
 	deactivate();
 	delete[] _boneJoints;
+	delete[] _keyCursors;
 }
 
 void AnimationStateEmi::activate() {
@@ -193,10 +213,40 @@ void AnimationStateEmi::computeWeights() {
 	}
 }
 
+// Returns the index of the first keyframe at or after the given time, or -1 if
+// there is none. The cursor holds the result of the previous lookup: when the
+// time moves forward the search goes on from there, otherwise (the animation
+// looped or was restarted) it falls back to a binary search.
+static int findKeyframe(const float *times, int count, float time, int &cursor, bool forward) {
+	int index;
+	if (forward) {
+		index = cursor;
+		while (index < count && times[index] < time) {
+			index++;
+		}
+	} else {
+		int low = 0, high = count;
+		while (low < high) {
+			int mid = (low + high) / 2;
+			if (times[mid] < time)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		index = low;
+	}
+
+	cursor = index;
+	return index < count ? index : -1;
+}
+
 void AnimationStateEmi::animate() {
 	if (_fade <= 0.0f)
 		return;
 
+	bool forward = _time >= _cursorTime;
+	_cursorTime = _time;
+
 	for (int bone = 0; bone < _anim->_numBones; ++bone) {
 		Bone &curBone = _anim->_bones[bone];
 		int jointIndex = _boneJoints[bone];
@@ -208,7 +258,6 @@ void AnimationStateEmi::animate() {
 		JointAnimation &jointAnim = layer->_jointAnims[jointIndex];
 
 		if (curBone._rotations) {
-			int keyfIdx = -1;
 			Math::Quaternion quat;
 
 			// Normalize the weight so that the sum of applied weights will equal 1.
@@ -218,12 +267,7 @@ void AnimationStateEmi::animate() {
 				normalizedRotWeight = _fade / jointAnim._rotWeight;
 			}
 
-			for (int curKeyFrame = 0; curKeyFrame < curBone._count; curKeyFrame++) {
-				if (curBone._rotations[curKeyFrame]._time >= _time) {
-					keyfIdx = curKeyFrame;
-					break;
-				}
-			}
+			int keyfIdx = findKeyframe(curBone._times, curBone._count, _time, _keyCursors[bone], forward);
 
 			if (keyfIdx == 0) {
 				quat = curBone._rotations[0]._quat;
@@ -245,7 +289,6 @@ void AnimationStateEmi::animate() {
 		}
 
 		if (curBone._translations) {
-			int keyfIdx = -1;
 			Math::Vector3d vec;
 
 			// Normalize the weight so that the sum of applied weights will equal 1.
@@ -255,12 +298,7 @@ void AnimationStateEmi::animate() {
 				normalizedTransWeight = _fade / jointAnim._transWeight;
 			}
 
-			for (int curKeyFrame = 0; curKeyFrame < curBone._count; curKeyFrame++) {
-				if (curBone._translations[curKeyFrame]._time >= _time) {
-					keyfIdx = curKeyFrame;
-					break;
-				}
-			}
+			int keyfIdx = findKeyframe(curBone._times, curBone._count, _time, _keyCursors[bone], forward);
 
 			if (keyfIdx == 0) {
 				vec = curBone._translations[0]._vec;
@@ -319,6 +357,8 @@ void AnimationStateEmi::setSkeleton(Skeleton *skel) {
 		if (_anim) {
 			for (int i = 0; i < _anim->_numBones; ++i) {
 				_boneJoints[i] = skel->findJointIndex(_anim->_bones[i]._boneName);
+				// animate() skips the bones without joint, restart their cursors
+				_keyCursors[i] = 0;
 			}
 		}
 	}
@@ -50,8 +50,10 @@ struct Bone {
 	int _count;
 	AnimRotation *_rotations;
 	AnimTranslation *_translations;
+	// Times of the keyframes, stored in AnimationEmi::_keyTimes
+	const float *_times;
 	Joint *_target;
-	Bone() : _rotations(NULL), _translations(NULL), _boneName(""), _operation(0), _target(NULL) {}
+	Bone() : _rotations(NULL), _translations(NULL), _times(NULL), _boneName(""), _operation(0), _target(NULL) {}
 	~Bone();
 	void loadBinary(Common::SeekableReadStream *data);
 };
@@ -64,6 +66,8 @@ public:
 	float _duration;
 	int _numBones;
 	Bone *_bones;
+	// The keyframe times of all the bones, packed for the keyframe lookups
+	float *_keyTimes;
 	AnimationEmi(const Common::String &filename, Common::SeekableReadStream *data);
 	~AnimationEmi();
 
@@ -105,6 +109,10 @@ private:
 	Animation::FadeMode _fadeMode;
 	int _fadeLength;
 	int *_boneJoints;
+
+	// Index of the current keyframe of each bone at _cursorTime
+	int *_keyCursors;
+	uint _cursorTime;
 };
 
 } // end of namespace Grim
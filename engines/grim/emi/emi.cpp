@@ -37,7 +37,8 @@ namespace Grim {
 EMIEngine *g_emi = nullptr;
 
 EMIEngine::EMIEngine(OSystem *syst, uint32 gameFlags, GrimGameType gameType, Common::Platform platform, Common::Language language) :
-		GrimEngine(syst, gameFlags, gameType, platform, language), _sortOrderInvalidated(false), _textObjectsSortOrderInvalidated(true) {
+		GrimEngine(syst, gameFlags, gameType, platform, language), _sortOrderInvalidated(false), _textObjectsSortOrderInvalidated(true),
+		_numDrawnModels(0), _numCulledModels(0), _lastFrameDrawnModels(0), _lastFrameCulledModels(0) {
 
 	g_emi = this;
 	g_emiregistry = new EmiRegistry();
@@ -131,6 +132,9 @@ void EMIEngine::purgeText() {
 }
 
 void EMIEngine::drawNormalMode() {
+	_numDrawnModels = 0;
+	_numCulledModels = 0;
+
 	_currSet->setupCamera();
 
 	g_driver->set3DMode();
@@ -185,6 +189,8 @@ void EMIEngine::drawNormalMode() {
 
 	flagRefreshShadowMask(false);
 
+	_lastFrameDrawnModels = _numDrawnModels;
+	_lastFrameCulledModels = _numCulledModels;
 }
 
 void EMIEngine::storeSaveGameImage(SaveGame *state) {
@@ -48,6 +48,19 @@ public:
 	void temporaryStoreSaveGameImage();
 	void storeSaveGameImage(SaveGame *state) override;
 
+	/**
+	 * Counts a model draw request, to report in the debugger how many
+	 * models were culled by the view frustum in the last frame.
+	 */
+	void countModelDraw(bool culled) {
+		if (culled)
+			_numCulledModels++;
+		else
+			_numDrawnModels++;
+	}
+	uint32 getLastFrameDrawnModels() const { return _lastFrameDrawnModels; }
+	uint32 getLastFrameCulledModels() const { return _lastFrameCulledModels; }
+
 private:
 	LuaBase *createLua() override;
 	void drawNormalMode() override;
@@ -61,6 +74,11 @@ private:
 
 	bool _textObjectsSortOrderInvalidated;
 	bool _sortOrderInvalidated;
+
+	uint32 _numDrawnModels;
+	uint32 _numCulledModels;
+	uint32 _lastFrameDrawnModels;
+	uint32 _lastFrameCulledModels;
 };
 
 extern EMIEngine *g_emi;
@@ -29,10 +29,19 @@
 #include "engines/grim/resource.h"
 #include "engines/grim/set.h"
 #include "engines/grim/emi/costumeemi.h"
+#include "engines/grim/emi/emi.h"
 #include "engines/grim/emi/modelemi.h"
 #include "engines/grim/emi/animationemi.h"
 #include "engines/grim/emi/skeleton.h"
 
+#if defined(__SSE__)
+#define EMI_SIMD_SKINNING
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define EMI_SIMD_SKINNING
+#include <arm_neon.h>
+#endif
+
 namespace Grim {
 
 struct Vector3int {
@@ -224,40 +233,126 @@ void EMIModel::setSkeleton(Skeleton *skel) {
 	for (int i = 0; i < _numBoneInfos; i++) {
 		_vertexBoneInfo[i] = _skeleton->findJointIndex(_boneNames[_boneInfos[i]._joint]);
 	}
+
+	delete[] _skinMatrices;
+	_skinMatrices = new float[16 * _skeleton->_numJoints];
+
+	if (!_boneVertex) {
+		// The bone infos of a vertex follow each other, the first one having _incFac set
+		_boneVertex = new int[_numBoneInfos];
+		int boneVert = -1;
+		for (int i = 0; i < _numBoneInfos; i++) {
+			if (_boneInfos[i]._incFac == 1) {
+				boneVert++;
+			}
+			_boneVertex[i] = boneVert;
+		}
+
+		_skinVertices = new float[4 * _numVertices];
+		_skinNormals = new float[4 * _numVertices];
+		_skinOutput = new float[8 * _numVertices];
+		for (int i = 0; i < _numVertices; i++) {
+			for (int j = 0; j < 3; j++) {
+				_skinVertices[4 * i + j] = _vertices[i].getValue(j);
+				_skinNormals[4 * i + j] = _normals[i].getValue(j);
+			}
+			_skinVertices[4 * i + 3] = 1.0f;
+			_skinNormals[4 * i + 3] = 0.0f;
+		}
+	}
+
+	// Distance from each joint to the farthest vertex it moves, in the bind pose
+	delete[] _jointRadius;
+	_jointRadius = new float[_skeleton->_numJoints];
+	for (int i = 0; i < _skeleton->_numJoints; i++) {
+		_jointRadius[i] = -1.0f;
+	}
+	for (int i = 0; i < _numBoneInfos; i++) {
+		int boneVert = _boneVertex[i];
+		int jointIndex = _vertexBoneInfo[i];
+		if (boneVert < 0 || jointIndex < 0)
+			continue;
+
+		Math::Vector3d bindPos = _skeleton->_joints[jointIndex]._absMatrix.getPosition();
+		float dist = (_vertices[boneVert] - bindPos).getMagnitude();
+		_jointRadius[jointIndex] = MAX(_jointRadius[jointIndex], dist);
+	}
+}
+
+// Adds the vertex and the normal transformed by a column major matrix and
+// scaled by the weight to the output, which holds the vertex then the normal.
+static inline void skinVertex(const float *matrix, float weight, const float *vertex, const float *normal, float *output) {
+#if defined(EMI_SIMD_SKINNING) && defined(__SSE__)
+	__m128 c0 = _mm_loadu_ps(matrix);
+	__m128 c1 = _mm_loadu_ps(matrix + 4);
+	__m128 c2 = _mm_loadu_ps(matrix + 8);
+	__m128 c3 = _mm_loadu_ps(matrix + 12);
+	__m128 w = _mm_set1_ps(weight);
+
+	__m128 v = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(vertex[0])), c3);
+	v = _mm_add_ps(v, _mm_mul_ps(c1, _mm_set1_ps(vertex[1])));
+	v = _mm_add_ps(v, _mm_mul_ps(c2, _mm_set1_ps(vertex[2])));
+	_mm_storeu_ps(output, _mm_add_ps(_mm_loadu_ps(output), _mm_mul_ps(v, w)));
+
+	__m128 n = _mm_mul_ps(c0, _mm_set1_ps(normal[0]));
+	n = _mm_add_ps(n, _mm_mul_ps(c1, _mm_set1_ps(normal[1])));
+	n = _mm_add_ps(n, _mm_mul_ps(c2, _mm_set1_ps(normal[2])));
+	_mm_storeu_ps(output + 4, _mm_add_ps(_mm_loadu_ps(output + 4), _mm_mul_ps(n, w)));
+#elif defined(EMI_SIMD_SKINNING)
+	float32x4_t c0 = vld1q_f32(matrix);
+	float32x4_t c1 = vld1q_f32(matrix + 4);
+	float32x4_t c2 = vld1q_f32(matrix + 8);
+	float32x4_t c3 = vld1q_f32(matrix + 12);
+
+	float32x4_t v = vmlaq_n_f32(c3, c0, vertex[0]);
+	v = vmlaq_n_f32(v, c1, vertex[1]);
+	v = vmlaq_n_f32(v, c2, vertex[2]);
+	vst1q_f32(output, vmlaq_n_f32(vld1q_f32(output), v, weight));
+
+	float32x4_t n = vmulq_n_f32(c0, normal[0]);
+	n = vmlaq_n_f32(n, c1, normal[1]);
+	n = vmlaq_n_f32(n, c2, normal[2]);
+	vst1q_f32(output + 4, vmlaq_n_f32(vld1q_f32(output + 4), n, weight));
+#else
+	for (int i = 0; i < 3; i++) {
+		float v = matrix[i] * vertex[0] + matrix[4 + i] * vertex[1] + matrix[8 + i] * vertex[2] + matrix[12 + i];
+		float n = matrix[i] * normal[0] + matrix[4 + i] * normal[1] + matrix[8 + i] * normal[2];
+		output[i] += v * weight;
+		output[4 + i] += n * weight;
+	}
+#endif
 }
 
 void EMIModel::prepareForRender() {
 	if (!_skeleton || !_vertexBoneInfo)
 		return;
 
-	for (int i = 0; i < _numVertices; i++) {
-		_drawVertices[i].set(0.0f, 0.0f, 0.0f);
-		_drawNormals[i].set(0.0f, 0.0f, 0.0f);
+	for (int i = 0; i < _skeleton->_numJoints; i++) {
+		const float *m = _skeleton->_joints[i]._skinMatrix.getData();
+		float *columns = _skinMatrices + 16 * i;
+		for (int col = 0; col < 4; col++) {
+			for (int row = 0; row < 4; row++) {
+				columns[4 * col + row] = m[4 * row + col];
+			}
+		}
 	}
 
-	int boneVert = -1;
-	for (int i = 0; i < _numBoneInfos; i++) {
-		if (_boneInfos[i]._incFac == 1) {
-			boneVert++;
-		}
+	memset(_skinOutput, 0, 8 * _numVertices * sizeof(float));
 
+	for (int i = 0; i < _numBoneInfos; i++) {
+		int boneVert = _boneVertex[i];
 		int jointIndex = _vertexBoneInfo[i];
-		const Math::Matrix4 &jointMatrix = _skeleton->_joints[jointIndex]._finalMatrix;
-		const Math::Matrix4 &bindPose = _skeleton->_joints[jointIndex]._absMatrix;
-
-		Math::Vector3d vert = _vertices[boneVert];
-		bindPose.inverseTranslate(&vert);
-		bindPose.inverseRotate(&vert);
-		jointMatrix.transform(&vert, true);
-		_drawVertices[boneVert] += vert * _boneInfos[i]._weight;
-
-		Math::Vector3d normal = _normals[boneVert];
-		bindPose.inverseRotate(&normal);
-		jointMatrix.transform(&normal, false);
-		_drawNormals[boneVert] += normal * _boneInfos[i]._weight;
+		if (boneVert < 0 || jointIndex < 0)
+			continue;
+
+		skinVertex(_skinMatrices + 16 * jointIndex, _boneInfos[i]._weight,
+		           _skinVertices + 4 * boneVert, _skinNormals + 4 * boneVert, _skinOutput + 8 * boneVert);
 	}
 
 	for (int i = 0; i < _numVertices; i++) {
+		const float *output = _skinOutput + 8 * i;
+		_drawVertices[i].set(output[0], output[1], output[2]);
+		_drawNormals[i].set(output[4], output[5], output[6]);
 		_drawNormals[i].normalize();
 	}
 
@@ -272,16 +367,20 @@ void EMIModel::prepareTextures() {
 }
 
 void EMIModel::draw() {
-	prepareForRender();
-
 	Actor *actor = _costume->getOwner();
 	Math::Matrix4 modelToWorld = actor->getFinalMatrix();
 
+	// Cull before skinning, the bounds only need the joints
 	if (!actor->isInOverworld()) {
 		Math::AABB bounds = calculateWorldBounds(modelToWorld);
-		if (bounds.isValid() && !g_grim->getCurrSet()->getFrustum().isInside(bounds))
+		if (bounds.isValid() && !g_grim->getCurrSet()->getFrustum().isInside(bounds)) {
+			g_emi->countModelDraw(true);
 			return;
+		}
 	}
+	g_emi->countModelDraw(false);
+
+	prepareForRender();
 
 	if (!g_driver->supportsShaders()) {
 		// If shaders are not available, we calculate lighting in software.
@@ -415,13 +514,35 @@ void EMIModel::getBoundingBox(int *x1, int *y1, int *x2, int *y2) const {
 
 Math::AABB EMIModel::calculateWorldBounds(const Math::Matrix4 &matrix) const {
 	Math::AABB bounds;
-	for (int i = 0; i < _numVertices; i++) {
-		bounds.expand(_drawVertices[i]);
+	if (_skeleton && _vertexBoneInfo) {
+		// A skinned vertex is a weighted average of its bind pose position moved
+		// rigidly by each of its joints, so it stays within the spheres around
+		// the animated joints.
+		for (int i = 0; i < _skeleton->_numJoints; i++) {
+			if (_jointRadius[i] < 0.0f)
+				continue;
+			Math::Vector3d center = _skeleton->_joints[i]._finalMatrix.getPosition();
+			Math::Vector3d extent(_jointRadius[i], _jointRadius[i], _jointRadius[i]);
+			bounds.expand(center - extent);
+			bounds.expand(center + extent);
+		}
+	} else {
+		for (int i = 0; i < _numVertices; i++) {
+			bounds.expand(_drawVertices[i]);
+		}
 	}
 	bounds.transform(matrix);
 	return bounds;
 }
 
+void EMIModel::releaseDriverData() {
+	g_driver->destroyEMIModel(this);
+}
+
+void EMIModel::createDriverData() {
+	g_driver->createEMIModel(this);
+}
+
 EMIModel::EMIModel(const Common::String &filename, Common::SeekableReadStream *data, EMICostume *costume) :
 		_fname(filename), _costume(costume) {
 	_numVertices = 0;
@@ -440,6 +561,12 @@ EMIModel::EMIModel(const Common::String &filename, Common::SeekableReadStream *d
 	_boneInfos = nullptr;
 	_numBoneInfos = 0;
 	_vertexBoneInfo = nullptr;
+	_boneVertex = nullptr;
+	_skinVertices = nullptr;
+	_skinNormals = nullptr;
+	_skinOutput = nullptr;
+	_skinMatrices = nullptr;
+	_jointRadius = nullptr;
 	_skeleton = nullptr;
 	_radius = 0;
 	_center = new Math::Vector3d();
@@ -451,12 +578,16 @@ EMIModel::EMIModel(const Common::String &filename, Common::SeekableReadStream *d
 	_lighting = nullptr;
 	_lightingDirty = true;
 	_texFlags = nullptr;
+	_userData = nullptr;
 
 	loadMesh(data);
 	g_driver->createEMIModel(this);
 }
 
 EMIModel::~EMIModel() {
+	g_driver->destroyEMIModel(this);
+	g_resourceloader->uncacheModelEmi(this);
+
 	delete[] _vertices;
 	delete[] _drawVertices;
 	delete[] _normals;
@@ -468,6 +599,12 @@ EMIModel::~EMIModel() {
 	delete[] _mats;
 	delete[] _boneInfos;
 	delete[] _vertexBoneInfo;
+	delete[] _boneVertex;
+	delete[] _skinVertices;
+	delete[] _skinNormals;
+	delete[] _skinOutput;
+	delete[] _skinMatrices;
+	delete[] _jointRadius;
 	delete[] _boneNames;
 	delete[] _lighting;
 	delete[] _texFlags;
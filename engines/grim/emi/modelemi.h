@@ -110,6 +110,14 @@ public:
 	Common::String *_boneNames;
 	int *_vertexBoneInfo;
 
+	// Skinning data, set up by setSkeleton() for prepareForRender()
+	int *_boneVertex;
+	float *_skinVertices;
+	float *_skinNormals;
+	float *_skinOutput;
+	float *_skinMatrices;
+	float *_jointRadius;
+
 	// Stuff we dont know how to use:
 	float _radius;
 	Math::Vector3d *_center;
@@ -133,6 +141,8 @@ public:
 	void prepareForRender();
 	void prepareTextures();
 	void draw();
+	void releaseDriverData();
+	void createDriverData();
 	void updateLighting(const Math::Matrix4 &modelToWorld);
 	void getBoundingBox(int *x1, int *y1, int *x2, int *y2) const;
 	Math::AABB calculateWorldBounds(const Math::Matrix4 &matrix) const;
@@ -82,6 +82,11 @@ void Skeleton::initBone(int index) {
 		// Might be the other way around.
 		_joints[index]._absMatrix =  _joints[index]._absMatrix * _joints[index]._relMatrix;
 	}
+
+	_joints[index]._inverseAbsMatrix = _joints[index]._absMatrix;
+	_joints[index]._inverseAbsMatrix.invertAffineOrthonormal();
+	// The final matrix stays the identity until the first animation
+	_joints[index]._skinMatrix = _joints[index]._inverseAbsMatrix;
 }
 
 void Skeleton::initBones() {
@@ -180,6 +185,7 @@ void Skeleton::commitAnim() {
 			_joints[m]._finalMatrix = _joints[m]._animMatrix;
 			_joints[m]._finalQuat = _joints[m]._animQuat;
 		}
+		_joints[m]._skinMatrix = _joints[m]._finalMatrix * _joints[m]._inverseAbsMatrix;
 	}
 }
 
@@ -46,11 +46,14 @@ struct Joint {
 	Math::Quaternion _quat;
 	int _parentIndex;
 	Math::Matrix4 _absMatrix;
+	Math::Matrix4 _inverseAbsMatrix;
 	Math::Matrix4 _relMatrix;
 	Math::Matrix4 _animMatrix;
 	Math::Quaternion _animQuat;
 	Math::Matrix4 _finalMatrix;
 	Math::Quaternion _finalQuat;
+	// Maps the bind pose to the animated pose, used for skinning
+	Math::Matrix4 _skinMatrix;
 };
 
 struct JointAnimation {
@@ -139,6 +139,16 @@ int Font::getStringHeight(const Common::String &text) const {
 	return result;
 }
 
+void Font::releaseDriverData() {
+	g_driver->destroyFont(this);
+	_userData = nullptr;
+}
+
+void Font::createDriverData() {
+	if (_fontData)
+		g_driver->createFont(this);
+}
+
 void Font::saveState(SaveGame *state) const {
 	state->writeString(getFilename());
 }
@@ -66,6 +66,9 @@ public:
 	void saveState(SaveGame *state) const;
 	void restoreState(SaveGame *state);
 
+	void releaseDriverData();
+	void createDriverData();
+
 	static const uint8 emerFont[][13];
 private:
 
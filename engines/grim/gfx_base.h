@@ -128,6 +128,7 @@ public:
 	virtual void startActorDraw(const Actor *act) = 0;
 	virtual void finishActorDraw() = 0;
 	virtual void setShadow(Shadow *shadow) = 0;
+	virtual void destroyShadow(Shadow *shadow) {}
 	virtual void drawShadowPlanes() = 0;
 	virtual void setShadowMode();
 	virtual void clearShadowMode();
@@ -259,12 +260,15 @@ public:
 
 	virtual void renderBitmaps(bool render);
 	virtual void renderZBitmaps(bool render);
+	bool getRenderBitmaps() const { return _renderBitmaps; }
+	bool getRenderZBitmaps() const { return _renderZBitmaps; }
 
 	virtual void makeScreenTextures();
 
 	virtual void createMesh(Mesh *mesh) {}
 	virtual void destroyMesh(const Mesh *mesh) {}
 	virtual void createEMIModel(EMIModel *model) {}
+	virtual void destroyEMIModel(EMIModel *model) {}
 	virtual void updateEMIModel(const EMIModel *model) {}
 
 	virtual int genBuffer() { return 0; }
@@ -864,6 +864,17 @@ void GfxOpenGLS::drawShadowPlanes() {
 	glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 }
 
+void GfxOpenGLS::destroyShadow(Shadow *shadow) {
+	ShadowUserData *sud = static_cast<ShadowUserData *>(shadow->userData);
+	if (!sud)
+		return;
+
+	glDeleteBuffers(1, &sud->_verticesVBO);
+	glDeleteBuffers(1, &sud->_indicesVBO);
+	delete sud;
+	shadow->userData = nullptr;
+}
+
 void GfxOpenGLS::setShadowMode() {
 	GfxBase::setShadowMode();
 }
@@ -1976,6 +1987,26 @@ void GfxOpenGLS::createEMIModel(EMIModel *model) {
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+void GfxOpenGLS::destroyEMIModel(EMIModel *model) {
+	EMIModelUserData *mud = static_cast<EMIModelUserData *>(model->_userData);
+	if (!mud)
+		return;
+
+	for (uint32 i = 0; i < model->_numFaces; ++i) {
+		EMIMeshFace *face = &model->_faces[i];
+		glDeleteBuffers(1, &face->_indicesEBO);
+		face->_indicesEBO = 0;
+	}
+	glDeleteBuffers(1, &mud->_verticesVBO);
+	glDeleteBuffers(1, &mud->_normalsVBO);
+	glDeleteBuffers(1, &mud->_texCoordsVBO);
+	glDeleteBuffers(1, &mud->_colorMapVBO);
+
+	delete mud->_shader;
+	delete mud;
+	model->_userData = nullptr;
+}
+
 void GfxOpenGLS::createMesh(Mesh *mesh) {
 	Common::Array<GrimVertex> meshInfo;
 	meshInfo.reserve(mesh->_numVertices * 5);
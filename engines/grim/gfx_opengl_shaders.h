@@ -74,6 +74,7 @@ public:
 
 	virtual void finishActorDraw() override;
 	virtual void setShadow(Shadow *shadow) override;
+	virtual void destroyShadow(Shadow *shadow) override;
 	virtual void drawShadowPlanes() override;
 	virtual void setShadowMode() override;
 	virtual void clearShadowMode() override;
@@ -205,6 +206,7 @@ public:
 	virtual void createMesh(Mesh *mesh) override;
 	virtual void destroyMesh(const Mesh *mesh) override;
 	virtual void createEMIModel(EMIModel *model) override;
+	virtual void destroyEMIModel(EMIModel *model) override;
 	virtual void updateEMIModel(const EMIModel* model) override;
 
 	virtual void setBlendMode(bool additive) override;
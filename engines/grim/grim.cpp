@@ -101,6 +101,8 @@ GrimEngine::GrimEngine(OSystem *syst, uint32 gameFlags, GrimGameType gameType, C
 	ConfMan.registerDefault("fullscreen", false);
 	ConfMan.registerDefault("show_fps", false);
 	ConfMan.registerDefault("use_arb_shaders", true);
+	ConfMan.registerDefault("resource_cache_size", 32 * 1024);
+	ConfMan.registerDefault("movie_seek_cache_size", 16 * 1024);
 
 	_showFps = ConfMan.getBool("show_fps");
 
@@ -243,6 +245,70 @@ void GrimEngine::createRenderer() {
 	}
 }
 
+void GrimEngine::changeDriver(uint screenWidth, uint screenHeight, bool fullscreen) {
+	debug("GrimEngine::changeDriver() started.");
+
+	byte r, g, b;
+	g_driver->getShadowColor(&r, &g, &b);
+	bool renderBitmaps = g_driver->getRenderBitmaps();
+	bool renderZBitmaps = g_driver->getRenderZBitmaps();
+
+	// Release everything the old driver created. The objects themselves,
+	// and with them the game state, stay as they are.
+	Common::Array<Actor *> cleanActors;
+	foreach (Actor *a, Actor::getPool()) {
+		if (a->hasCleanBuffer())
+			cleanActors.push_back(a);
+		a->clearCleanBuffer();
+		a->releaseShadowData();
+	}
+	foreach (TextObject *t, TextObject::getPool()) {
+		t->destroy();
+	}
+	foreach (Font *f, Font::getPool()) {
+		f->releaseDriverData();
+	}
+	foreach (Bitmap *bitmap, Bitmap::getPool()) {
+		bitmap->_data->releaseDriverData();
+	}
+	g_resourceloader->releaseDriverData();
+	g_driver->releaseMovieFrame();
+
+	delete g_driver;
+	createRenderer();
+	g_driver->setupScreen(screenWidth, screenHeight, fullscreen);
+	g_driver->setShadowColor(r, g, b);
+	g_driver->renderBitmaps(renderBitmaps);
+	g_driver->renderZBitmaps(renderZBitmaps);
+
+	// Text objects are created again the next time they are drawn
+	g_resourceloader->createDriverData();
+	foreach (Bitmap *bitmap, Bitmap::getPool()) {
+		bitmap->_data->createDriverData();
+	}
+	foreach (Font *f, Font::getPool()) {
+		f->createDriverData();
+	}
+	// Shadow planes are uploaded again when they are next drawn, but the
+	// movie frame on screen has to be handed over now
+	if (g_movie->isPlaying() && g_movie->getFrame() >= 0) {
+		g_driver->prepareMovieFrame(g_movie->getDstSurface());
+		_prevSmushFrame = -1;
+	}
+
+	if (_currSet) {
+		g_driver->refreshBuffers();
+		_currSet->setupCamera();
+		g_driver->set3DMode();
+		foreach (Actor *a, cleanActors) {
+			a->update(0);
+			a->drawToCleanBuffer();
+		}
+	}
+
+	debug("GrimEngine::changeDriver() finished.");
+}
+
 const char *GrimEngine::getUpdateFilename() {
 	if (getGameFlags() & ADGF_DEMO)
 		return nullptr;
@@ -753,14 +819,7 @@ void GrimEngine::mainLoop() {
 
 			EngineMode mode = getMode();
 
-			_savegameFileName = "";
-			savegameSave();
-			clearPools();
-
-			delete g_driver;
-			createRenderer();
-			g_driver->setupScreen(screenWidth, screenHeight, fullscreen);
-			savegameRestore();
+			changeDriver(screenWidth, screenHeight, fullscreen);
 
 			if (mode == DrawMode) {
 				setMode(GrimEngine::NormalMode);
@@ -775,6 +834,7 @@ void GrimEngine::mainLoop() {
 		g_sound->flushTracks();
 		if (g_imuse) {
 			g_imuse->refreshScripts();
+			g_imuse->readAhead();
 		}
 
 		_debugger->onFrame();
@@ -203,6 +203,7 @@ protected:
 	void buildActiveActorsList();
 	void savegameCallback();
 	void createRenderer();
+	void changeDriver(uint screenWidth, uint screenHeight, bool fullscreen);
 	void playAspyrLogo();
 	virtual LuaBase *createLua();
 	virtual void updateNormalMode();
@@ -305,7 +305,7 @@ void Imuse::callback() {
 					track->stream->queueBuffer(data, result, DisposeAfterUse::YES, makeMixerFlags(track->mixerFlags));
 					track->regionOffset += result;
 				} else
-					delete[] data;
+					free(data);
 
 				if (_sound->isEndOfRegion(track->soundDesc, track->curRegion)) {
 					switchToNextRegion(track);
@@ -323,6 +323,60 @@ void Imuse::callback() {
 	}
 }
 
+/*
+ * Decodes the next blocks of the playing sounds, so that the timer callback
+ * finds them ready. This is called from the main loop: the track list is
+ * only locked to find the sounds, and the decoding itself only locks the
+ * sound being decoded.
+ */
+void Imuse::readAhead() {
+	for (int l = 0; l < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; l++) {
+		_mutex.lock();
+		Track *track = _track[l];
+		if (_pause || !track->used || !track->stream || !track->soundDesc || track->curRegion == -1 ||
+				!_sound->lockSound(track->soundDesc)) {
+			_mutex.unlock();
+			continue;
+		}
+
+		// The sound cannot be closed while it is locked
+		ImuseSndMgr::SoundDesc *soundDesc = track->soundDesc;
+		Track copy = *track;
+		_mutex.unlock();
+
+		readAhead(&copy);
+		_sound->unlockSound(soundDesc);
+	}
+}
+
+void Imuse::readAhead(Track *track) {
+	ImuseSndMgr::SoundDesc *soundDesc = track->soundDesc;
+	int32 size = 2 * track->feedSize / _callbackFps;
+
+	// The current region and the jump target share the blocks the sound
+	// can keep decoded, the current region coming first
+	int blocks = _sound->getMaxReadAheadBlocks();
+	blocks -= _sound->readAheadRegion(soundDesc, track->curRegion, track->regionOffset, size, blocks);
+
+	// Also prepare the start of the region switchToNextRegion() will go to,
+	// so that music jumps don't have to seek and decode on the spot
+	if (track->trackId >= MAX_IMUSE_TRACKS || blocks <= 0)
+		return;
+
+	int nextRegion = track->curRegion + 1;
+	if (nextRegion == _sound->getNumRegions(soundDesc))
+		return;
+
+	int jumpId = _sound->getJumpIdByRegionAndHookId(soundDesc, nextRegion, track->curHookId);
+	if (jumpId == -1 && track->curHookId != 128)
+		jumpId = _sound->getJumpIdByRegionAndHookId(soundDesc, nextRegion, 0);
+	if (jumpId != -1)
+		nextRegion = _sound->getRegionIdByJumpId(soundDesc, jumpId);
+
+	if (nextRegion >= 0)
+		_sound->readAheadRegion(soundDesc, nextRegion, 0, size, blocks);
+}
+
 void Imuse::switchToNextRegion(Track *track) {
 	assert(track);
 
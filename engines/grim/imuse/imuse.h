@@ -59,6 +59,7 @@ private:
 	static void timerHandler(void *refConf);
 	void callback();
 	void switchToNextRegion(Track *track);
+	void readAhead(Track *track);
 	int allocSlot(int priority);
 	void selectVolumeGroup(const char *soundName, int volGroupId);
 
@@ -107,6 +108,7 @@ public:
 	int getCurMusicVol();
 	bool getSoundStatus(const char *soundName);
 	int32 getPosIn16msTicks(const char *soundName);
+	void readAhead();
 };
 
 extern Imuse *g_imuse;
@@ -36,12 +36,19 @@ McmpMgr::McmpMgr() {
 	_numCompItems = 0;
 	_curSample = -1;
 	_compInput = nullptr;
-	_outputSize = 0;
 	_file = nullptr;
-	_lastBlock = -1;
+	_useCounter = 0;
+	for (int i = 0; i < kNumCachedBlocks; i++) {
+		_cache[i].block = -1;
+		_cache[i].size = 0;
+		_cache[i].lastUse = 0;
+	}
 }
 
 McmpMgr::~McmpMgr() {
+	// Wait for a read-ahead still using the sound
+	Common::StackLock lock(_mutex);
+
 	delete[] _compTable;
 	delete[] _compInput;
 }
@@ -88,61 +95,112 @@ bool McmpMgr::openSound(const char *filename, Common::SeekableReadStream *data,
 	return true;
 }
 
-int32 McmpMgr::decompressSample(int32 offset, int32 size, byte **comp_final) {
-	int32 i, final_size, output_size;
-	int skip, first_block, last_block;
+McmpMgr::CachedBlock *McmpMgr::findCachedBlock(int block) {
+	for (int i = 0; i < kNumCachedBlocks; i++) {
+		if (_cache[i].block == block)
+			return &_cache[i];
+	}
+	return nullptr;
+}
+
+McmpMgr::CachedBlock *McmpMgr::decompressBlock(int block) {
+	assert(block >= 0 && block < _numCompItems);
+
+	CachedBlock *cached = findCachedBlock(block);
+	if (!cached) {
+		// Reuse the least recently used slot
+		cached = &_cache[0];
+		for (int i = 1; i < kNumCachedBlocks; i++) {
+			if (_cache[i].lastUse < cached->lastUse)
+				cached = &_cache[i];
+		}
+
+		// hack: two more zero bytes at the end of input buffer
+		_compInput[_compTable[block].compSize] = 0;
+		_compInput[_compTable[block].compSize + 1] = 0;
+		_file->seek(_compTable[block].offset, SEEK_SET);
+		_file->read(_compInput, _compTable[block].compSize);
+		if (_compTable[block].decompSize > kBlockSize) {
+			error("McmpMgr::decompressBlock() decompSize: %d", _compTable[block].decompSize);
+		}
+		decompressVima(_compInput, (int16 *)cached->data, _compTable[block].decompSize, imuseDestTable);
+		cached->block = block;
+		cached->size = _compTable[block].decompSize;
+	}
 
+	cached->lastUse = ++_useCounter;
+	return cached;
+}
+
+const byte *McmpMgr::getSampleView(int32 offset, int32 &size) {
 	if (!_file) {
-		error("McmpMgr::decompressSampleByName() File is not open!");
-		return 0;
+		error("McmpMgr::getSampleView() File is not open!");
+		return nullptr;
 	}
 
-	first_block = offset / 0x2000;
-	last_block = (offset + size - 1) / 0x2000;
-	skip = offset % 0x2000;
-
-	// Clip last_block by the total number of blocks (= "comp items")
-	if ((last_block >= _numCompItems) && (_numCompItems > 0))
-		last_block = _numCompItems - 1;
-
-	int32 blocks_final_size = 0x2000 * (1 + last_block - first_block);
-	*comp_final = (byte *)malloc(blocks_final_size * sizeof(byte));
-	final_size = 0;
-
-	for (i = first_block; i <= last_block; i++) {
-		if (_lastBlock != i) {
-			// hack: two more zero bytes at the end of input buffer
-			_compInput[_compTable[i].compSize] = 0;
-			_compInput[_compTable[i].compSize + 1] = 0;
-			_file->seek(_compTable[i].offset, SEEK_SET);
-			_file->read(_compInput, _compTable[i].compSize);
-			decompressVima(_compInput, (int16 *)_compOutput, _compTable[i].decompSize, imuseDestTable);
-			_outputSize = _compTable[i].decompSize;
-			if (_outputSize > 0x2000) {
-				error("McmpMgr::decompressSample() _outputSize: %d", _outputSize);
-			}
-			_lastBlock = i;
-		}
+	int block = offset / kBlockSize;
+	int skip = offset % kBlockSize;
+	if (block >= _numCompItems) {
+		size = 0;
+		return nullptr;
+	}
+
+	CachedBlock *cached = decompressBlock(block);
+	int32 available = MAX<int32>(cached->size - skip, 0);
+	if (size > available)
+		size = available;
 
-		output_size = _outputSize - skip;
+	return cached->data + skip;
+}
 
-		if ((output_size + skip) > 0x2000) // workaround
-			output_size -= (output_size + skip) - 0x2000;
+int McmpMgr::readAhead(int32 offset, int32 size, int maxBlocks) {
+	Common::StackLock lock(_mutex);
 
-		if (output_size > size)
-			output_size = size;
+	if (!_file || size <= 0 || maxBlocks <= 0)
+		return 0;
 
-		assert(final_size + output_size <= blocks_final_size);
+	int first_block = offset / kBlockSize;
+	int last_block = MIN<int>((offset + size - 1) / kBlockSize, _numCompItems - 1);
 
-		memcpy(*comp_final + final_size, _compOutput + skip, output_size);
-		final_size += output_size;
+	// Never read further ahead than the cache can hold, or the blocks
+	// would evict each other before they are used
+	maxBlocks = MIN<int>(maxBlocks, kMaxReadAheadBlocks);
+	if (last_block - first_block >= maxBlocks)
+		last_block = first_block + maxBlocks - 1;
 
-		size -= output_size;
-		assert(size >= 0);
-		if (size == 0)
+	// decompressBlock() also marks the blocks already in the cache as
+	// used, so that they are not the ones evicted next
+	for (int i = first_block; i <= last_block; i++)
+		decompressBlock(i);
+
+	return MAX<int>(last_block - first_block + 1, 0);
+}
+
+int32 McmpMgr::decompressSample(int32 offset, int32 size, byte **comp_final) {
+	if (!_file) {
+		error("McmpMgr::decompressSampleByName() File is not open!");
+		return 0;
+	}
+
+	Common::StackLock lock(_mutex);
+
+	// The caller takes ownership of the buffer, so the cached blocks are
+	// copied out instead of being handed over directly
+	*comp_final = (byte *)malloc(MAX<int32>(size, 1));
+	int32 final_size = 0;
+
+	while (size > 0) {
+		int32 output_size = size;
+		const byte *data = getSampleView(offset, output_size);
+		if (output_size == 0)
 			break;
 
-		skip = 0;
+		memcpy(*comp_final + final_size, data, output_size);
+		final_size += output_size;
+		size -= output_size;
+
+		// The view stops at the end of a block, continue with the next one
+		offset = (offset / kBlockSize + 1) * kBlockSize;
 	}
 
 	return final_size;
@@ -23,11 +23,18 @@
 #ifndef GRIM_MCMP_MGR_H
 #define GRIM_MCMP_MGR_H
 
+#include "common/mutex.h"
+
 namespace Grim {
 
 class McmpMgr {
 private:
 
+	enum {
+		kBlockSize = 0x2000,
+		kNumCachedBlocks = 8
+	};
+
 	struct CompTable {
 		byte codec;
 		int32 decompSize;
@@ -35,22 +42,42 @@ private:
 		int32 offset;
 	};
 
+	struct CachedBlock {
+		int block;
+		int32 size;
+		uint32 lastUse;
+		byte data[kBlockSize];
+	};
+
 	CompTable *_compTable;
 	int16 _numCompItems;
 	int _curSample;
 	Common::SeekableReadStream *_file;
-	byte _compOutput[0x2000];
 	byte *_compInput;
-	int _outputSize;
-	int _lastBlock;
+	CachedBlock _cache[kNumCachedBlocks];
+	uint32 _useCounter;
+	// Held while the cache or the file is used, the read-ahead runs in
+	// another thread than the one playing the sound
+	Common::Mutex _mutex;
+
+	CachedBlock *findCachedBlock(int block);
+	CachedBlock *decompressBlock(int block);
 
 public:
 
+	enum {
+		// Leave room for the block being played and the one after it
+		kMaxReadAheadBlocks = kNumCachedBlocks - 2
+	};
+
 	McmpMgr();
 	~McmpMgr();
 
 	bool openSound(const char *filename, Common::SeekableReadStream *data, int &offsetData);
 	int32 decompressSample(int32 offset, int32 size, byte **comp_final);
+	const byte *getSampleView(int32 offset, int32 &size);
+	int readAhead(int32 offset, int32 size, int maxBlocks);
+	Common::Mutex &getMutex() { return _mutex; }
 };
 
 } // end of namespace Grim
@@ -215,6 +215,8 @@ ImuseSndMgr::SoundDesc *ImuseSndMgr::openSound(const char *soundName, int volGro
 void ImuseSndMgr::closeSound(SoundDesc *sound) {
 	assert(checkForProperHandle(sound));
 
+	// Deleting the decoder waits for a read-ahead of this sound to end, so
+	// it has to go first, before the regions it reads are freed
 	if (sound->mcmpMgr) {
 		delete sound->mcmpMgr;
 		sound->mcmpMgr = nullptr;
@@ -364,4 +366,38 @@ int32 ImuseSndMgr::getDataFromRegion(SoundDesc *sound, int region, byte **buf, i
 	return size;
 }
 
+int ImuseSndMgr::readAheadRegion(SoundDesc *sound, int region, int32 offset, int32 size, int maxBlocks) {
+	assert(checkForProperHandle(sound));
+	assert(region >= 0 && region < sound->numRegions);
+
+	// Only compressed sounds are worth decoding ahead of time
+	if (!sound->mcmpData)
+		return 0;
+
+	int32 region_offset = sound->region[region].offset;
+	int32 region_length = sound->region[region].length;
+	if (offset + size > region_length)
+		size = region_length - offset;
+
+	return sound->mcmpMgr->readAhead(region_offset + offset, size, maxBlocks);
+}
+
+int ImuseSndMgr::getMaxReadAheadBlocks() const {
+	return McmpMgr::kMaxReadAheadBlocks;
+}
+
+bool ImuseSndMgr::lockSound(SoundDesc *sound) {
+	assert(checkForProperHandle(sound));
+
+	if (!sound->mcmpData)
+		return false;
+
+	sound->mcmpMgr->getMutex().lock();
+	return true;
+}
+
+void ImuseSndMgr::unlockSound(SoundDesc *sound) {
+	sound->mcmpMgr->getMutex().unlock();
+}
+
 } // end of namespace Grim
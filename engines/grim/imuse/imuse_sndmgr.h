@@ -112,6 +112,12 @@ public:
 	int getJumpFade(SoundDesc *sound, int number);
 
 	int32 getDataFromRegion(SoundDesc *sound, int region, byte **buf, int32 offset, int32 size);
+	int readAheadRegion(SoundDesc *sound, int region, int32 offset, int32 size, int maxBlocks);
+	int getMaxReadAheadBlocks() const;
+	// Keeps a compressed sound from being decoded or closed by another
+	// thread. Returns false if the sound is not compressed.
+	bool lockSound(SoundDesc *sound);
+	void unlockSound(SoundDesc *sound);
 };
 
 } // end of namespace Grim
@@ -21,8 +21,8 @@
  */
 
 #include "common/file.h"
-#include "common/substream.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
 
 #include "engines/grim/grim.h"
 #include "engines/grim/lab.h"
@@ -38,12 +38,75 @@ Common::SeekableReadStream *LabEntry::createReadStream() const {
 	return _parent->createReadStreamForMember(_name);
 }
 
+struct LabDataDeleter {
+	void operator()(byte *data) { free(data); }
+};
+
+/**
+ * The archive file of a non-resident Lab, opened once and shared by the
+ * member streams. Sounds are read from the mixer thread, so the file is
+ * only positioned and read with the mutex held.
+ */
+struct LabFile {
+	Common::File _file;
+	Common::Mutex _mutex;
+};
+
+class LabMemberStream : public Common::SeekableReadStream {
+public:
+	LabMemberStream(const Common::SharedPtr<LabFile> &file, uint32 offset, uint32 len) :
+			_file(file), _offset(offset), _len(len), _pos(0), _eos(false) {}
+
+	bool eos() const override { return _eos; }
+	bool err() const override { return _file->_file.err(); }
+	void clearErr() override { _eos = false; _file->_file.clearErr(); }
+	int32 pos() const override { return _pos; }
+	int32 size() const override { return _len; }
+	bool seek(int32 offset, int whence = SEEK_SET) override;
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+private:
+	Common::SharedPtr<LabFile> _file;
+	uint32 _offset, _len, _pos;
+	bool _eos;
+};
+
+bool LabMemberStream::seek(int32 offset, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offset += _len;
+		break;
+	case SEEK_CUR:
+		offset += _pos;
+		break;
+	}
+
+	if (offset < 0 || (uint32)offset > _len)
+		return false;
+
+	_pos = offset;
+	_eos = false;
+	return true;
+}
+
+uint32 LabMemberStream::read(void *dataPtr, uint32 dataSize) {
+	if (dataSize > _len - _pos) {
+		dataSize = _len - _pos;
+		_eos = true;
+	}
+
+	Common::StackLock lock(_file->_mutex);
+	_file->_file.seek(_offset + _pos, SEEK_SET);
+	dataSize = _file->_file.read(dataPtr, dataSize);
+	_pos += dataSize;
+
+	return dataSize;
+}
+
 Lab::Lab() {
-	_stream = nullptr;
 }
 
 Lab::~Lab() {
-	delete _stream;
 }
 
 bool Lab::open(const Common::String &filename, bool keepStream) {
@@ -51,7 +114,8 @@ bool Lab::open(const Common::String &filename, bool keepStream) {
 
 	bool result = true;
 
-	Common::File *file = new Common::File();
+	Common::SharedPtr<LabFile> labFile(new LabFile());
+	Common::File *file = &labFile->_file;
 	if (!file->open(filename) || file->readUint32BE() != MKTAG('L','A','B','N')) {
 		result = false;
 	} else {
@@ -66,9 +130,11 @@ bool Lab::open(const Common::String &filename, bool keepStream) {
 		file->seek(0, SEEK_SET);
 		byte *data = static_cast<byte*>(malloc(sizeof(byte) * file->size()));
 		file->read(data, file->size());
-		_stream = new Common::MemoryReadStream(data, file->size(), DisposeAfterUse::YES);
+		_data = Common::SharedPtr<byte>(data, LabDataDeleter());
+	} else if (result) {
+		// Every member is read through this one file handle
+		_file = labFile;
 	}
-	delete file;
 
 	return result;
 }
@@ -180,15 +246,11 @@ Common::SeekableReadStream *Lab::createReadStreamForMember(const Common::String
 	fname.toLowercase();
 	LabEntryPtr i = _entries[fname];
 
-	if (!_stream) {
-		Common::File *file = new Common::File();
-		file->open(_labFileName);
-		return new Common::SeekableSubReadStream(file, i->_offset, i->_offset + i->_len, DisposeAfterUse::YES);
+	if (!_data) {
+		return new LabMemberStream(_file, i->_offset, i->_len);
 	} else {
-		byte *data = static_cast<byte*>(malloc(sizeof(byte) * i->_len));
-		_stream->seek(i->_offset, SEEK_SET);
-		_stream->read(data, i->_len);
-		return new Common::MemoryReadStream(data, i->_len, DisposeAfterUse::YES);
+		// Members are views into the resident archive, no copy is made.
+		return new Common::SharedMemoryReadStream(_data, i->_offset, i->_len);
 	}
 }
 
@@ -24,6 +24,7 @@
 #define GRIM_LAB_H
 
 #include "common/archive.h"
+#include "common/ptr.h"
 
 namespace Common {
 	class File;
@@ -32,6 +33,7 @@ namespace Common {
 namespace Grim {
 
 class Lab;
+struct LabFile;
 
 class LabEntry : public Common::ArchiveMember {
 	Lab *_parent;
@@ -63,7 +65,10 @@ private:
 	typedef Common::SharedPtr<LabEntry> LabEntryPtr;
 	typedef Common::HashMap<Common::String, LabEntryPtr, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> LabMap;
 	LabMap _entries;
-	Common::SeekableReadStream *_stream;
+	// Whole archive contents when kept in memory, shared with the member streams.
+	Common::SharedPtr<byte> _data;
+	// Otherwise the archive file, shared with the member streams.
+	Common::SharedPtr<LabFile> _file;
 };
 
 } // end of namespace Grim
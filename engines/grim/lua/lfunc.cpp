@@ -9,6 +9,7 @@
 #include "engines/grim/lua/lfunc.h"
 #include "engines/grim/lua/lmem.h"
 #include "engines/grim/lua/lstate.h"
+#include "engines/grim/lua/lvm.h"
 
 namespace Grim {
 
@@ -49,6 +50,7 @@ void luaF_freeproto(TProtoFunc *l) {
 	while (l) {
 		TProtoFunc *next = (TProtoFunc *)l->head.next;
 		nblocks -= gcsizeproto(l);
+		luaV_forgetproto(l);
 		freefunc(l);
 		l = next;
 	}
@@ -17,8 +17,30 @@
 #include "engines/grim/lua/ltm.h"
 #include "engines/grim/lua/lua.h"
 
+#include "common/system.h"
+
 namespace Grim {
 
+/*
+** The collector is incremental: objects reachable from the roots are made
+** gray (marked == 1) and pushed on the gray stack, and each step pops a
+** limited number of them, marks their children and makes them black
+** (marked == 2). Closures and protos never change once built, so only
+** stores into black tables need a barrier; the stack, globals, locks and tag
+** methods are scanned again atomically before sweeping.
+*/
+
+enum GCState {
+	GCSpause,
+	GCSpropagate
+};
+
+static GCState gcstate = GCSpause;
+static TObject *graystack = nullptr;
+static int32 graysize = 0;
+static int32 graytop = 0;
+static GCStats gcstats;
+
 static int32 markobject (TObject *o);
 
 /*
@@ -145,50 +167,59 @@ static GCnode *listcollect(GCnode *l) {
 	return frees;
 }
 
+static void pushgray(TObject *o, GCnode *head) {
+	if (graytop >= graysize)
+		graysize = luaM_growvector(&graystack, graysize, TObject, memEM, MAX_INT);
+	TObject *gray = &graystack[graytop++];
+	*gray = *o;
+	if (ttype(gray) == LUA_T_CLMARK)
+		ttype(gray) = LUA_T_CLOSURE;
+	else if (ttype(gray) == LUA_T_PMARK)
+		ttype(gray) = LUA_T_PROTO;
+	head->marked = 1;
+}
+
 static void strmark(TaggedString *s) {
 	if (!s->head.marked)
 		s->head.marked = 1;
 }
 
-static void protomark(TProtoFunc *f) {
-	if (!f->head.marked) {
-		LocVar *v = f->locvars;
-		int32 i;
-		f->head.marked = 1;
-		if (f->fileName)
-			strmark(f->fileName);
-		for (i = 0; i < f->nconsts; i++)
-			markobject(&f->consts[i]);
-		if (v) {
-			for (; v->line != -1; v++) {
-				if (v->varname)
-					strmark(v->varname);
-			}
+static int32 protomark(TProtoFunc *f) {
+	LocVar *v = f->locvars;
+	int32 i;
+	f->head.marked = 2;
+	if (f->fileName)
+		strmark(f->fileName);
+	for (i = 0; i < f->nconsts; i++)
+		markobject(&f->consts[i]);
+	if (v) {
+		for (; v->line != -1; v++) {
+			if (v->varname)
+				strmark(v->varname);
 		}
 	}
+	return f->nconsts + 1;
 }
 
-static void closuremark(Closure *f) {
-	if (!f->head.marked) {
-		int32 i;
-		f->head.marked = 1;
-		for (i = f->nelems; i >= 0; i--)
-			markobject(&f->consts[i]);
-	}
+static int32 closuremark(Closure *f) {
+	int32 i;
+	f->head.marked = 2;
+	for (i = f->nelems; i >= 0; i--)
+		markobject(&f->consts[i]);
+	return f->nelems + 1;
 }
 
-static void hashmark(Hash *h) {
-	if (!h->head.marked) {
-		int32 i;
-		h->head.marked = 1;
-		for (i = 0; i < nhash(h); i++) {
-			Node *n = node(h, i);
-			if (ttype(ref(n)) != LUA_T_NIL) {
-				markobject(&n->ref);
-				markobject(&n->val);
-			}
+static int32 hashmark(Hash *h) {
+	int32 i;
+	h->head.marked = 2;
+	for (i = 0; i < nhash(h); i++) {
+		Node *n = node(h, i);
+		if (ttype(ref(n)) != LUA_T_NIL) {
+			markobject(&n->ref);
+			markobject(&n->val);
 		}
 	}
+	return nhash(h) + 1;
 }
 
 static void globalmark() {
@@ -207,15 +238,18 @@ static int32 markobject(TObject *o) {
 		strmark(tsvalue(o));
 		break;
 	case LUA_T_ARRAY:
-		hashmark(avalue(o));
+		if (!avalue(o)->head.marked)
+			pushgray(o, &avalue(o)->head);
 		break;
 	case LUA_T_CLOSURE:
 	case LUA_T_CLMARK:
-		closuremark(o->value.cl);
+		if (!o->value.cl->head.marked)
+			pushgray(o, &o->value.cl->head);
 		break;
 	case LUA_T_PROTO:
 	case LUA_T_PMARK:
-		protomark(o->value.tf);
+		if (!o->value.tf->head.marked)
+			pushgray(o, &o->value.tf->head);
 		break;
 	default:
 		break;  // numbers, cprotos, etc
@@ -223,6 +257,22 @@ static int32 markobject(TObject *o) {
 	return 0;
 }
 
+// Blackens the object on top of the gray stack, returns the work it took
+static int32 propagatemark() {
+	TObject *o = &graystack[--graytop];
+	switch (ttype(o)) {
+	case LUA_T_ARRAY:
+		return hashmark(avalue(o));
+	case LUA_T_CLOSURE:
+		return closuremark(o->value.cl);
+	case LUA_T_PROTO:
+		return protomark(o->value.tf);
+	default:
+		LUA_INTERNALERROR("internal error");
+		return 1;
+	}
+}
+
 static void markall() {
 	luaD_travstack(markobject); // mark stack objects
 	globalmark();  // mark global variable values and names
@@ -230,19 +280,28 @@ static void markall() {
 	luaT_travtagmethods(markobject);  // mark fallbacks
 }
 
-int32 lua_collectgarbage(int32 limit) {
-	int32 recovered = nblocks;  // to subtract nblocks after gc
+static void startcycle() {
+	gcstate = GCSpropagate;
+	markall();
+}
+
+static void finishcycle(int32 limit) {
 	Hash *freetable;
 	TaggedString *freestr;
 	TProtoFunc *freefunc;
 	Closure *freeclos;
+	// the roots may have changed since the cycle started
 	markall();
+	while (graytop > 0)
+		propagatemark();
+	gcstate = GCSpause;
+	gcstats.cycles++;
 	invalidaterefs();
 	freestr = luaS_collector();
 	freetable = (Hash *)listcollect(&roottable);
 	freefunc = (TProtoFunc *)listcollect(&rootproto);
 	freeclos = (Closure *)listcollect(&rootcl);
-	GCthreshold *= 4;  // to avoid GC during GC
+	GCthreshold = MAX_INT;  // to avoid GC during GC
 	luaC_hashcallIM(freetable);  // GC tag methods for tables
 	luaC_strcallIM(freestr);  // GC tag methods for userdata
 	luaD_gcIM(&luaO_nilobject);  // GC tag method for nil (signal end of GC)
@@ -250,14 +309,82 @@ int32 lua_collectgarbage(int32 limit) {
 	luaS_free(freestr);
 	luaF_freeproto(freefunc);
 	luaF_freeclosure(freeclos);
-	recovered = recovered - nblocks;
 	GCthreshold = (limit == 0) ? 2 * nblocks : nblocks + limit;
+}
+
+// Runs the collector for about 'work' units, returns the work actually done
+static int32 singlestep(int32 work) {
+	uint32 start = g_system->getMillis();
+	int32 done = 0;
+	if (gcstate == GCSpause)
+		startcycle();
+	while (graytop > 0 && done < work)
+		done += propagatemark();
+	if (graytop == 0)
+		finishcycle(0);
+
+	uint32 pause = g_system->getMillis() - start;
+	gcstats.steps++;
+	gcstats.work += done;
+	gcstats.lastPause = pause;
+	if (pause > gcstats.maxPause)
+		gcstats.maxPause = pause;
+	return done;
+}
+
+void luaC_barrierback(Hash *h) {
+	// the table was already traversed, make it gray again so that the new
+	// value gets marked too
+	if (gcstate == GCSpropagate) {
+		TObject o;
+		ttype(&o) = LUA_T_ARRAY;
+		avalue(&o) = h;
+		pushgray(&o, &h->head);
+	}
+}
+
+void luaC_step() {
+	if (gcstate == GCSpropagate)
+		singlestep(GCSTEPSIZE);
+}
+
+const GCStats &luaC_getstats() {
+	return gcstats;
+}
+
+void luaC_init() {
+	gcstate = GCSpause;
+	graystack = nullptr;
+	graysize = 0;
+	graytop = 0;
+}
+
+void luaC_close() {
+	luaM_free(graystack);
+	luaC_init();
+}
+
+int32 lua_collectgarbage(int32 limit) {
+	int32 recovered = nblocks;  // to subtract nblocks after gc
+	uint32 start = g_system->getMillis();
+	if (gcstate == GCSpause)
+		startcycle();
+	finishcycle(limit);
+	uint32 pause = g_system->getMillis() - start;
+	gcstats.lastPause = pause;
+	if (pause > gcstats.maxPause)
+		gcstats.maxPause = pause;
+	recovered = recovered - nblocks;
 	return recovered;
 }
 
 void luaC_checkGC() {
-	if (nblocks >= GCthreshold)
-		lua_collectgarbage(0);
+	if (nblocks >= GCthreshold) {
+		singlestep(GCSTEPMUL * GARBAGE_BLOCK);
+		// pace the rest of the cycle with the allocations
+		if (gcstate == GCSpropagate)
+			GCthreshold = nblocks + GARBAGE_BLOCK;
+	}
 }
 
 } // end of namespace Grim
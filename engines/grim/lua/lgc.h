@@ -11,7 +11,25 @@
 
 namespace Grim {
 
+#define GCSTEPSIZE	1000	// work done by the collector step run every frame
+#define GCSTEPMUL	4	// work done per allocated block while a cycle is running
+
+struct GCStats {
+	int32 cycles;      // completed collection cycles
+	int32 steps;       // incremental steps
+	int32 work;        // objects and slots traversed by the steps
+	uint32 lastPause;  // duration of the last step, in ms
+	uint32 maxPause;   // longest step or full collection, in ms
+
+	GCStats() : cycles(0), steps(0), work(0), lastPause(0), maxPause(0) {}
+};
+
+void luaC_init();
+void luaC_close();
 void luaC_checkGC();
+void luaC_step();
+void luaC_barrierback(Hash *h);
+const GCStats &luaC_getstats();
 TObject* luaC_getref(int32 r);
 int32 luaC_ref(TObject *o, int32 lock);
 void luaC_hashcallIM(Hash *l);
@@ -171,6 +171,38 @@ typedef enum {
 	POP1			//	-		-				-				TOP-=2
 } OpCode;
 
+// The opcodes above, in the same order, for building tables indexed by opcode
+#define LUA_OPCODES(X) \
+	X(ENDCODE) \
+	X(PUSHNIL) X(PUSHNIL0) \
+	X(PUSHNUMBER) X(PUSHNUMBER0) X(PUSHNUMBER1) X(PUSHNUMBER2) X(PUSHNUMBERW) \
+	X(PUSHCONSTANT) X(PUSHCONSTANT0) X(PUSHCONSTANT1) X(PUSHCONSTANT2) X(PUSHCONSTANT3) X(PUSHCONSTANT4) X(PUSHCONSTANT5) X(PUSHCONSTANT6) X(PUSHCONSTANT7) X(PUSHCONSTANTW) \
+	X(PUSHUPVALUE) X(PUSHUPVALUE0) X(PUSHUPVALUE1) \
+	X(PUSHLOCAL) X(PUSHLOCAL0) X(PUSHLOCAL1) X(PUSHLOCAL2) X(PUSHLOCAL3) X(PUSHLOCAL4) X(PUSHLOCAL5) X(PUSHLOCAL6) X(PUSHLOCAL7) \
+	X(GETGLOBAL) X(GETGLOBAL0) X(GETGLOBAL1) X(GETGLOBAL2) X(GETGLOBAL3) X(GETGLOBAL4) X(GETGLOBAL5) X(GETGLOBAL6) X(GETGLOBAL7) X(GETGLOBALW) \
+	X(GETTABLE) \
+	X(GETDOTTED) X(GETDOTTED0) X(GETDOTTED1) X(GETDOTTED2) X(GETDOTTED3) X(GETDOTTED4) X(GETDOTTED5) X(GETDOTTED6) X(GETDOTTED7) X(GETDOTTEDW) \
+	X(PUSHSELF) X(PUSHSELF0) X(PUSHSELF1) X(PUSHSELF2) X(PUSHSELF3) X(PUSHSELF4) X(PUSHSELF5) X(PUSHSELF6) X(PUSHSELF7) X(PUSHSELFW) \
+	X(CREATEARRAY) X(CREATEARRAY0) X(CREATEARRAY1) X(CREATEARRAYW) \
+	X(SETLOCAL) X(SETLOCAL0) X(SETLOCAL1) X(SETLOCAL2) X(SETLOCAL3) X(SETLOCAL4) X(SETLOCAL5) X(SETLOCAL6) X(SETLOCAL7) \
+	X(SETGLOBAL) X(SETGLOBAL0) X(SETGLOBAL1) X(SETGLOBAL2) X(SETGLOBAL3) X(SETGLOBAL4) X(SETGLOBAL5) X(SETGLOBAL6) X(SETGLOBAL7) X(SETGLOBALW) \
+	X(SETTABLE0) X(SETTABLE) \
+	X(SETLIST) X(SETLIST0) X(SETLISTW) \
+	X(SETMAP) X(SETMAP0) \
+	X(EQOP) X(NEQOP) X(LTOP) X(LEOP) X(GTOP) X(GEOP) \
+	X(ADDOP) X(SUBOP) X(MULTOP) X(DIVOP) X(POWOP) X(CONCOP) X(MINUSOP) X(NOTOP) \
+	X(ONTJMP) X(ONTJMPW) \
+	X(ONFJMP) X(ONFJMPW) \
+	X(JMP) X(JMPW) \
+	X(IFFJMP) X(IFFJMPW) \
+	X(IFTUPJMP) X(IFTUPJMPW) \
+	X(IFFUPJMP) X(IFFUPJMPW) \
+	X(CLOSURE) X(CLOSURE0) X(CLOSURE1) \
+	X(CALLFUNC) X(CALLFUNC0) X(CALLFUNC1) \
+	X(RETCODE) \
+	X(SETLINE) X(SETLINEW) \
+	X(POP) X(POP0) X(POP1)
+
 #define RFIELDS_PER_FLUSH 32	// records (SETMAP)
 #define LFIELDS_PER_FLUSH 64    // lists (SETLIST)
 #define ZEROVARARG	64
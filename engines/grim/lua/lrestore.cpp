@@ -600,6 +600,8 @@ void lua_Restore(SaveGame *savedState) {
 	for (; currentState; currentState--)
 		lua_state = lua_state->next;
 
+	lua_taskreschedule();
+
 	arraysAllreadySort = false;
 	arrayStringsCount = 0;
 	arrayHashTablesCount = 0;
@@ -337,6 +337,8 @@ void lua_Save(SaveGame *savedState) {
 
 	savedState->writeLESint32(globalTaskSerialId);
 
+	lua_tasksyncsleep();
+
 	int32 countStates = 0, currentState = 0;
 	LState *state = lua_rootState;
 	while (state) {
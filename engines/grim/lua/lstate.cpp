@@ -91,6 +91,11 @@ void lua_stateinit(LState *state) {
 	state->some_task = nullptr;
 	state->taskFunc.ttype = LUA_T_NIL;
 	state->sleepFor = 0;
+	state->wakeTime = 0;
+	state->heapIndex = -1;
+	state->runs = 0;
+	state->runTime = 0;
+	state->maxRunTime = 0;
 
 	state->stack.stack = luaM_newvector(STACK_UNIT, TObject);
 	state->stack.top = state->stack.stack;
@@ -98,6 +103,8 @@ void lua_stateinit(LState *state) {
 }
 
 void lua_statedeinit(LState *state) {
+	lua_taskcancel(state);
+
 	if (state->prev)
 		state->prev->next = state->next;
 	if (state->next)
@@ -133,6 +140,7 @@ void lua_resetglobals() {
 	GCthreshold = GARBAGE_BLOCK;
 	nblocks = 0;
 
+	luaC_init();
 	luaD_init();
 	luaS_init();
 	luaX_init();
@@ -224,6 +232,7 @@ void lua_close() {
 	luaM_free(IMtable);
 	luaM_free(refArray);
 	luaM_free(Mbuffer);
+	luaC_close();
 
 	LState *tmpState, *state;
 	for (state = lua_rootState; state != nullptr;) {
@@ -106,6 +106,11 @@ struct LState {
 	struct C_Lua_Stack Cblocks[MAX_C_BLOCKS];
 	int numCblocks; // number of nested Cblocks
 	int sleepFor;
+	uint32 wakeTime; // task clock value the sleep ends at
+	int32 heapIndex; // position in the sleep heap, -1 if awake
+	int32 runs;      // number of times the task was resumed
+	uint32 runTime;  // total time spent running the task, in ms
+	uint32 maxRunTime; // longest single resume, in ms
 };
 
 extern LState *lua_state, *lua_rootState;
@@ -8,15 +8,147 @@
 #include "engines/grim/lua/ltask.h"
 #include "engines/grim/lua/lapi.h"
 #include "engines/grim/lua/lauxlib.h"
+#include "engines/grim/lua/lgc.h"
 #include "engines/grim/lua/lmem.h"
 #include "engines/grim/lua/ldo.h"
 #include "engines/grim/lua/lvm.h"
+#include "engines/grim/lua/lstring.h"
 #include "engines/grim/grim.h"
 
+#include "common/array.h"
+#include "common/str.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 
 namespace Grim {
 
+// Sleeping tasks wait in a binary min-heap ordered by the time they wake up at,
+// so a frame only looks at the tasks whose sleep actually ran out. The clock
+// advances by the frame time every lua_runtasks() and is compared with
+// wrap-around safe arithmetic.
+static Common::Array<LState *> sleepHeap;
+static uint32 taskClock = 0;
+
+static bool wakesBefore(LState *a, LState *b) {
+	return (int32)(a->wakeTime - b->wakeTime) < 0;
+}
+
+static void heapSet(uint32 index, LState *state) {
+	sleepHeap[index] = state;
+	state->heapIndex = index;
+}
+
+static void heapSiftUp(uint32 index) {
+	LState *state = sleepHeap[index];
+	while (index > 0) {
+		uint32 parent = (index - 1) / 2;
+		if (!wakesBefore(state, sleepHeap[parent]))
+			break;
+		heapSet(index, sleepHeap[parent]);
+		index = parent;
+	}
+	heapSet(index, state);
+}
+
+static void heapSiftDown(uint32 index) {
+	LState *state = sleepHeap[index];
+	uint32 size = sleepHeap.size();
+	for (;;) {
+		uint32 child = index * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && wakesBefore(sleepHeap[child + 1], sleepHeap[child]))
+			child++;
+		if (!wakesBefore(sleepHeap[child], state))
+			break;
+		heapSet(index, sleepHeap[child]);
+		index = child;
+	}
+	heapSet(index, state);
+}
+
+static void heapPush(LState *state) {
+	sleepHeap.push_back(state);
+	heapSiftUp(sleepHeap.size() - 1);
+}
+
+void lua_taskcancel(LState *state) {
+	if (state->heapIndex < 0)
+		return;
+
+	uint32 index = state->heapIndex;
+	LState *last = sleepHeap.back();
+	sleepHeap.pop_back();
+	state->heapIndex = -1;
+	if (last != state) {
+		heapSet(index, last);
+		heapSiftUp(index);
+		heapSiftDown(last->heapIndex);
+	}
+}
+
+static void scheduleSleep(LState *state) {
+	lua_taskcancel(state);
+	// The root state is never run as a task, so it never wakes up either
+	if (state->sleepFor > 0 && state != lua_rootState) {
+		state->wakeTime = taskClock + state->sleepFor;
+		heapPush(state);
+	}
+}
+
+// Bring sleepFor up to date for the sleeping tasks, it is what gets saved
+void lua_tasksyncsleep() {
+	for (uint32 i = 0; i < sleepHeap.size(); i++)
+		sleepHeap[i]->sleepFor = (int32)(sleepHeap[i]->wakeTime - taskClock);
+}
+
+// Put the tasks of a freshly restored state list back to sleep
+void lua_taskreschedule() {
+	for (LState *state = lua_rootState->next; state != nullptr; state = state->next)
+		scheduleSleep(state);
+}
+
+static TObject *nameTarget;
+
+static int32 checktask(TObject *o) {
+	return luaO_equalObj(o, nameTarget);
+}
+
+// Name for the task function identify_script() returns: the global it is
+// stored in, or where it was defined.
+static Common::String taskName(LState *state) {
+	nameTarget = &state->taskFunc;
+	const char *name = luaS_travsymbol(checktask);
+	if (name)
+		return name;
+	if (state->taskFunc.ttype == LUA_T_PROTO) {
+		TProtoFunc *tf = tfvalue(&state->taskFunc);
+		return Common::String::format("function (%s:%d)", tf->fileName->str, tf->lineDefined);
+	} else if (state->taskFunc.ttype == LUA_T_CPROTO) {
+		return "C function";
+	}
+	return "(nil)";
+}
+
+void lua_gettaskinfo(Common::Array<lua_TaskInfo> &tasks) {
+	tasks.clear();
+	if (!lua_rootState)
+		return;
+
+	lua_tasksyncsleep();
+	for (LState *state = lua_rootState->next; state != nullptr; state = state->next) {
+		lua_TaskInfo info;
+		info.id = state->id;
+		info.name = taskName(state);
+		info.paused = state->paused || state->all_paused;
+		info.sleepFor = state->heapIndex >= 0 ? state->sleepFor : 0;
+		info.runs = state->runs;
+		info.runTime = state->runTime;
+		info.maxRunTime = state->maxRunTime;
+		tasks.push_back(info);
+	}
+}
+
 void lua_taskinit(lua_Task *task, lua_Task *next, StkId tbase, int results) {
 	task->some_flag = 0;
 	task->next = next;
@@ -315,6 +447,7 @@ void sleep_for() {
 	if (lua_isnumber(msObj)) {
 		int ms = (int)lua_getnumber(msObj);
 		lua_state->sleepFor = ms;
+		scheduleSleep(lua_state);
 	}
 }
 
@@ -323,17 +456,25 @@ void lua_runtasks() {
 		return;
 	}
 
-	// Mark all the states to be updated
+	// Wake up the tasks whose sleep ran out by the end of the last frame
+	while (!sleepHeap.empty() && (int32)(sleepHeap[0]->wakeTime - taskClock) <= 0) {
+		LState *state = sleepHeap[0];
+		state->sleepFor = (int32)(state->wakeTime - taskClock);
+		lua_taskcancel(state);
+	}
+	taskClock += g_grim->getFrameTime();
+
+	// Mark all the awake states to be updated
 	LState *state = lua_state->next;
 	do {
-		if (state->sleepFor > 0) {
-			state->sleepFor -= g_grim->getFrameTime();
-		} else {
+		if (state->heapIndex < 0)
 			state->updated = false;
-		}
 		state = state->next;
 	} while	(state);
 
+	// Give the collector its share of the frame
+	luaC_step();
+
 	// And run them
 	runtasks(lua_state);
 }
@@ -344,6 +485,7 @@ void runtasks(LState *const rootState) {
 		LState *nextState = nullptr;
 		bool stillRunning;
 		if (!lua_state->all_paused && !lua_state->updated && !lua_state->paused) {
+			uint32 start = g_system->getMillis();
 			jmp_buf	errorJmp;
 			lua_state->errorJmp = &errorJmp;
 			if (setjmp(errorJmp)) {
@@ -365,6 +507,12 @@ void runtasks(LState *const rootState) {
 					stillRunning = luaD_call(base + 1, 255);
 				}
 			}
+			uint32 elapsed = g_system->getMillis() - start;
+			lua_state->runs++;
+			lua_state->runTime += elapsed;
+			if (elapsed > lua_state->maxRunTime)
+				lua_state->maxRunTime = elapsed;
+
 			nextState = lua_state->next;
 			// The state returned. Delete it
 			if (!stillRunning) {
@@ -38,6 +38,10 @@ void sleep_for();
 
 void runtasks(LState *const rootState);
 
+void lua_taskcancel(LState *state);
+void lua_tasksyncsleep();
+void lua_taskreschedule();
+
 } // end of namespace Grim
 
 #endif
@@ -10,6 +10,7 @@
 #define GRIM_LUA_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/str.h"
 
 namespace Common {
@@ -134,6 +135,37 @@ int32 lua_collectgarbage(int32 limit);
 void lua_runtasks();
 void current_script();
 
+struct lua_TaskInfo {
+	uint32 id;
+	Common::String name; // global holding the task function, or where it was defined
+	bool paused;
+	int32 sleepFor;      // time left to sleep, in ms, 0 if awake
+	int32 runs;
+	uint32 runTime;      // total run time, in ms
+	uint32 maxRunTime;   // longest single run, in ms
+};
+
+void lua_gettaskinfo(Common::Array<lua_TaskInfo> &tasks);
+
+struct lua_FunctionProfile {
+	Common::String name; // file and line the function is defined at
+	uint32 calls;        // times the interpreter entered or resumed it
+	uint32 instructions;
+	uint32 msecs;
+
+	lua_FunctionProfile() : calls(0), instructions(0), msecs(0) {}
+};
+
+struct lua_OpcodeProfile {
+	const char *name;
+	uint32 count;
+};
+
+void lua_setprofiling(bool enable);
+bool lua_isprofiling();
+void lua_resetprofile();
+void lua_getprofile(Common::Array<lua_FunctionProfile> &functions, Common::Array<lua_OpcodeProfile> &opcodes);
+
 /* some useful macros/derived functions */
 
 #define lua_call(name)		lua_callfunction(lua_getglobal(name))
@@ -20,6 +20,18 @@
 #include "engines/grim/lua/luadebug.h"
 #include "engines/grim/lua/lvm.h"
 
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/system.h"
+#include "common/util.h"
+
+// Dispatch every opcode through its own indirect jump from a table of label
+// addresses where the compiler supports it. Define LUA_SWITCH_DISPATCH to
+// build the plain switch instead.
+#if !defined(LUA_SWITCH_DISPATCH) && (defined(__clang__) || __GNUC__ >= 5)
+#define LUA_COMPUTED_GOTO
+#endif
+
 namespace Grim {
 
 #define skip_word(pc)	(pc += 2)
@@ -241,7 +253,132 @@ static void adjust_varargs(StkId first_extra_arg) {
 	*lua_state->stack.top++ = arg;
 }
 
-StkId luaV_execute(lua_Task *task) {
+/*
+** Profiler: counts the instructions run per function and per opcode, and the
+** time spent in each function. The clock only has millisecond resolution, so
+** every run of a function is charged the number of clock ticks it spanned; over
+** many runs that adds up to the real time. Time spent in tag methods called
+** by a function is included in it.
+*/
+
+struct ProtoProfile {
+	Common::String name;
+	uint32 calls;
+	uint32 instructions;
+	uint32 msecs;
+};
+
+struct ProtoHash {
+	uint operator()(const TProtoFunc *tf) const { return (uint)(size_t)tf >> 3; }
+};
+
+typedef Common::HashMap<TProtoFunc *, ProtoProfile, ProtoHash> ProtoProfileMap;
+typedef Common::HashMap<Common::String, lua_FunctionProfile> RetiredProfileMap;
+
+#define OPNAME(op) #op,
+static const char *const opnames[] = { LUA_OPCODES(OPNAME) };
+#undef OPNAME
+
+// LUA_OPCODES must list every opcode, or the dispatch table is off
+typedef char opcodeListComplete[ARRAYSIZE(opnames) == POP1 + 1 ? 1 : -1];
+
+static bool profiling = false;
+static uint32 opcodeCounts[ARRAYSIZE(opnames)];
+static ProtoProfileMap protoProfiles;
+// Functions freed by the collector, merged by name
+static RetiredProfileMap retiredProfiles;
+
+static void addProfile(lua_FunctionProfile &p, const ProtoProfile &add) {
+	p.calls += add.calls;
+	p.instructions += add.instructions;
+	p.msecs += add.msecs;
+}
+
+void lua_setprofiling(bool enable) {
+	profiling = enable;
+}
+
+bool lua_isprofiling() {
+	return profiling;
+}
+
+void lua_resetprofile() {
+	protoProfiles.clear();
+	retiredProfiles.clear();
+	memset(opcodeCounts, 0, sizeof(opcodeCounts));
+}
+
+void lua_getprofile(Common::Array<lua_FunctionProfile> &functions, Common::Array<lua_OpcodeProfile> &opcodes) {
+	RetiredProfileMap merged = retiredProfiles;
+	for (ProtoProfileMap::const_iterator i = protoProfiles.begin(); i != protoProfiles.end(); ++i) {
+		lua_FunctionProfile &p = merged[i->_value.name];
+		p.name = i->_value.name;
+		addProfile(p, i->_value);
+	}
+
+	functions.clear();
+	for (RetiredProfileMap::const_iterator i = merged.begin(); i != merged.end(); ++i)
+		functions.push_back(i->_value);
+
+	opcodes.clear();
+	for (int i = 0; i < ARRAYSIZE(opnames); i++) {
+		lua_OpcodeProfile op;
+		op.name = opnames[i];
+		op.count = opcodeCounts[i];
+		opcodes.push_back(op);
+	}
+}
+
+void luaV_forgetproto(TProtoFunc *tf) {
+	ProtoProfileMap::iterator i = protoProfiles.find(tf);
+	if (i == protoProfiles.end())
+		return;
+
+	lua_FunctionProfile &p = retiredProfiles[i->_value.name];
+	p.name = i->_value.name;
+	addProfile(p, i->_value);
+	protoProfiles.erase(i);
+}
+
+static ProtoProfile *getProfile(TProtoFunc *tf) {
+	ProtoProfileMap::iterator i = protoProfiles.find(tf);
+	if (i != protoProfiles.end())
+		return &i->_value;
+
+	// The name is taken now, the file name string may be freed before tf is
+	ProtoProfile &p = protoProfiles[tf];
+	p.name = Common::String::format("%s:%d", tf->fileName->str, tf->lineDefined);
+	p.calls = 0;
+	p.instructions = 0;
+	p.msecs = 0;
+	return &p;
+}
+
+#define vmfetch() \
+	{ \
+		task->aux = *task->pc++; \
+		if (prof) { \
+			prof->instructions++; \
+			opcodeCounts[task->aux]++; \
+		} \
+	}
+
+#ifdef LUA_COMPUTED_GOTO
+#define vmdispatch(o)	goto *disptab[o];
+#define vmcase(l)	L_##l:
+#define vmbreak		{ vmfetch(); vmdispatch(task->aux); }
+#else
+#define vmdispatch(o)	switch ((OpCode)(o))
+#define vmcase(l)	case l:
+#define vmbreak		break
+#endif
+
+#ifdef LUA_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+static StkId execute(lua_Task *task, ProtoProfile *prof) {
 	if (!task->some_flag) {
 		luaD_checkstack((*task->pc++) + EXTRA_STACK);
 		if (*task->pc < ZEROVARARG) {
@@ -254,100 +391,107 @@ StkId luaV_execute(lua_Task *task) {
 	}
 	lua_state->state_counter2++;
 
+#ifdef LUA_COMPUTED_GOTO
+#define OPLABEL(op) &&L_##op,
+	static const void *const disptab[] = { LUA_OPCODES(OPLABEL) };
+#undef OPLABEL
+#endif
+
 	while (1) {
-		switch ((OpCode)(task->aux = *task->pc++)) {
-		case PUSHNIL0:
+		vmfetch();
+		vmdispatch(task->aux) {
+		vmcase(PUSHNIL0)
 			ttype(task->S->top++) = LUA_T_NIL;
-			break;
-		case PUSHNIL:
+			vmbreak;
+		vmcase(PUSHNIL)
 			task->aux = *task->pc++;
 			do {
 				ttype(task->S->top++) = LUA_T_NIL;
 			} while (task->aux--);
-			break;
-		case PUSHNUMBER:
+			vmbreak;
+		vmcase(PUSHNUMBER)
 			task->aux = *task->pc++;
 			goto pushnumber;
-		case PUSHNUMBERW:
+		vmcase(PUSHNUMBERW)
 			task->aux = next_word(task->pc);
 			goto pushnumber;
-		case PUSHNUMBER0:
-		case PUSHNUMBER1:
-		case PUSHNUMBER2:
+		vmcase(PUSHNUMBER0)
+		vmcase(PUSHNUMBER1)
+		vmcase(PUSHNUMBER2)
 			task->aux -= PUSHNUMBER0;
 pushnumber:
 			ttype(task->S->top) = LUA_T_NUMBER;
 			nvalue(task->S->top) = (float)task->aux;
 			task->S->top++;
-			break;
-		case PUSHLOCAL:
+			vmbreak;
+		vmcase(PUSHLOCAL)
 			task->aux = *task->pc++;
 			goto pushlocal;
-		case PUSHLOCAL0:
-		case PUSHLOCAL1:
-		case PUSHLOCAL2:
-		case PUSHLOCAL3:
-		case PUSHLOCAL4:
-		case PUSHLOCAL5:
-		case PUSHLOCAL6:
-		case PUSHLOCAL7:
+		vmcase(PUSHLOCAL0)
+		vmcase(PUSHLOCAL1)
+		vmcase(PUSHLOCAL2)
+		vmcase(PUSHLOCAL3)
+		vmcase(PUSHLOCAL4)
+		vmcase(PUSHLOCAL5)
+		vmcase(PUSHLOCAL6)
+		vmcase(PUSHLOCAL7)
 			task->aux -= PUSHLOCAL0;
 pushlocal:
 			*task->S->top++ = *((task->S->stack + task->base) + task->aux);
-			break;
-		case GETGLOBALW:
+			vmbreak;
+		vmcase(GETGLOBALW)
 			task->aux = next_word(task->pc);
 			goto getglobal;
-		case GETGLOBAL:
+		vmcase(GETGLOBAL)
 			task->aux = *task->pc++;
 			goto getglobal;
-		case GETGLOBAL0:
-		case GETGLOBAL1:
-		case GETGLOBAL2:
-		case GETGLOBAL3:
-		case GETGLOBAL4:
-		case GETGLOBAL5:
-		case GETGLOBAL6:
-		case GETGLOBAL7:
+		vmcase(GETGLOBAL0)
+		vmcase(GETGLOBAL1)
+		vmcase(GETGLOBAL2)
+		vmcase(GETGLOBAL3)
+		vmcase(GETGLOBAL4)
+		vmcase(GETGLOBAL5)
+		vmcase(GETGLOBAL6)
+		vmcase(GETGLOBAL7)
 			task->aux -= GETGLOBAL0;
 getglobal:
 			luaV_getglobal(tsvalue(&task->consts[task->aux]));
-			break;
-		case GETTABLE:
+			vmbreak;
+		vmcase(GETTABLE)
 			luaV_gettable();
-			break;
-		case GETDOTTEDW:
+			vmbreak;
+		vmcase(GETDOTTEDW)
 			task->aux = next_word(task->pc); goto getdotted;
-		case GETDOTTED:
+		vmcase(GETDOTTED)
 			task->aux = *task->pc++;
 			goto getdotted;
-		case GETDOTTED0:
-		case GETDOTTED1:
-		case GETDOTTED2:
-		case GETDOTTED3:
-		case GETDOTTED4:
-		case GETDOTTED5:
-		case GETDOTTED6:
-		case GETDOTTED7:
+		vmcase(GETDOTTED0)
+		vmcase(GETDOTTED1)
+		vmcase(GETDOTTED2)
+		vmcase(GETDOTTED3)
+		vmcase(GETDOTTED4)
+		vmcase(GETDOTTED5)
+		vmcase(GETDOTTED6)
+		vmcase(GETDOTTED7)
 			task->aux -= GETDOTTED0;
 getdotted:
 			*task->S->top++ = task->consts[task->aux];
 			luaV_gettable();
-			break;
-		case PUSHSELFW:
+			vmbreak;
+		vmcase(PUSHSELFW)
 			task->aux = next_word(task->pc);
 			goto pushself;
-		case PUSHSELF:
+		vmcase(PUSHSELF)
 			task->aux = *task->pc++;
 			goto pushself;
-		case PUSHSELF0:
-		case PUSHSELF1:
-		case PUSHSELF2:
-		case PUSHSELF3:
-		case PUSHSELF4:
-		case PUSHSELF5:
-		case PUSHSELF6:
-		case PUSHSELF7:
+		vmcase(PUSHSELF0)
+		vmcase(PUSHSELF1)
+		vmcase(PUSHSELF2)
+		vmcase(PUSHSELF3)
+		vmcase(PUSHSELF4)
+		vmcase(PUSHSELF5)
+		vmcase(PUSHSELF6)
+		vmcase(PUSHSELF7)
 			task->aux -= PUSHSELF0;
 pushself:
 			{
@@ -355,81 +499,81 @@ pushself:
 				*task->S->top++ = task->consts[task->aux];
 				luaV_gettable();
 				*task->S->top++ = receiver;
-				break;
+				vmbreak;
 			}
-		case PUSHCONSTANTW:
+		vmcase(PUSHCONSTANTW)
 			task->aux = next_word(task->pc);
 			goto pushconstant;
-		case PUSHCONSTANT:
+		vmcase(PUSHCONSTANT)
 			task->aux = *task->pc++; goto pushconstant;
-		case PUSHCONSTANT0:
-		case PUSHCONSTANT1:
-		case PUSHCONSTANT2:
-		case PUSHCONSTANT3:
-		case PUSHCONSTANT4:
-		case PUSHCONSTANT5:
-		case PUSHCONSTANT6:
-		case PUSHCONSTANT7:
+		vmcase(PUSHCONSTANT0)
+		vmcase(PUSHCONSTANT1)
+		vmcase(PUSHCONSTANT2)
+		vmcase(PUSHCONSTANT3)
+		vmcase(PUSHCONSTANT4)
+		vmcase(PUSHCONSTANT5)
+		vmcase(PUSHCONSTANT6)
+		vmcase(PUSHCONSTANT7)
 			task->aux -= PUSHCONSTANT0;
 pushconstant:
 			*task->S->top++ = task->consts[task->aux];
-			break;
-		case PUSHUPVALUE:
+			vmbreak;
+		vmcase(PUSHUPVALUE)
 			task->aux = *task->pc++;
 			goto pushupvalue;
-		case PUSHUPVALUE0:
-		case PUSHUPVALUE1:
+		vmcase(PUSHUPVALUE0)
+		vmcase(PUSHUPVALUE1)
 			task->aux -= PUSHUPVALUE0;
 pushupvalue:
 			*task->S->top++ = task->cl->consts[task->aux + 1];
-			break;
-		case SETLOCAL:
+			vmbreak;
+		vmcase(SETLOCAL)
 			task->aux = *task->pc++;
 			goto setlocal;
-		case SETLOCAL0:
-		case SETLOCAL1:
-		case SETLOCAL2:
-		case SETLOCAL3:
-		case SETLOCAL4:
-		case SETLOCAL5:
-		case SETLOCAL6:
-		case SETLOCAL7:
+		vmcase(SETLOCAL0)
+		vmcase(SETLOCAL1)
+		vmcase(SETLOCAL2)
+		vmcase(SETLOCAL3)
+		vmcase(SETLOCAL4)
+		vmcase(SETLOCAL5)
+		vmcase(SETLOCAL6)
+		vmcase(SETLOCAL7)
 			task->aux -= SETLOCAL0;
 setlocal:
 			*((task->S->stack + task->base) + task->aux) = *(--task->S->top);
-			break;
-		case SETGLOBALW:
+			vmbreak;
+		vmcase(SETGLOBALW)
 			task->aux = next_word(task->pc);
 			goto setglobal;
-		case SETGLOBAL:
+		vmcase(SETGLOBAL)
 			task->aux = *task->pc++;
 			goto setglobal;
-		case SETGLOBAL0:
-		case SETGLOBAL1:
-		case SETGLOBAL2:
-		case SETGLOBAL3:
-		case SETGLOBAL4:
-		case SETGLOBAL5:
-		case SETGLOBAL6:
-		case SETGLOBAL7:
+		vmcase(SETGLOBAL0)
+		vmcase(SETGLOBAL1)
+		vmcase(SETGLOBAL2)
+		vmcase(SETGLOBAL3)
+		vmcase(SETGLOBAL4)
+		vmcase(SETGLOBAL5)
+		vmcase(SETGLOBAL6)
+		vmcase(SETGLOBAL7)
 			task->aux -= SETGLOBAL0;
 setglobal:
 			luaV_setglobal(tsvalue(&task->consts[task->aux]));
-			break;
-		case SETTABLE0:
+			vmbreak;
+		vmcase(SETTABLE0)
 			luaV_settable(task->S->top - 3, 1);
-			break;
-		case SETTABLE:
+			vmbreak;
+		vmcase(SETTABLE)
 			luaV_settable(task->S->top - 3 - (*task->pc++), 2);
-			break;
-		case SETLISTW:
+			vmbreak;
+		vmcase(SETLISTW)
 			task->aux = next_word(task->pc);
 			task->aux *= LFIELDS_PER_FLUSH;
 			goto setlist;
-		case SETLIST:
+		vmcase(SETLIST)
 			task->aux = *(task->pc++) * LFIELDS_PER_FLUSH;
 			goto setlist;
-		case SETLIST0:
+		vmcase(SETLIST0)
 			task->aux = 0;
 setlist:
 			{
@@ -441,12 +585,12 @@ setlist:
 					*(luaH_set(avalue(arr), task->S->top)) = *(task->S->top - 1);
 					task->S->top--;
 			}
-			break;
+			vmbreak;
 		}
-		case SETMAP0:
+		vmcase(SETMAP0)
 			task->aux = 0;
 			goto setmap;
-		case SETMAP:
+		vmcase(SETMAP)
 			task->aux = *task->pc++;
 setmap:
 			{
@@ -455,34 +599,34 @@ setmap:
 					*(luaH_set(avalue(arr), task->S->top - 2)) = *(task->S->top - 1);
 					task->S->top -= 2;
 				} while (task->aux--);
-				break;
+				vmbreak;
 			}
-		case POP:
+		vmcase(POP)
 			task->aux = *task->pc++;
 			goto pop;
-		case POP0:
-		case POP1:
+		vmcase(POP0)
+		vmcase(POP1)
 			task->aux -= POP0;
 pop:
 			task->S->top -= (task->aux + 1);
-			break;
-		case CREATEARRAYW:
+			vmbreak;
+		vmcase(CREATEARRAYW)
 			task->aux = next_word(task->pc);
 			goto createarray;
-		case CREATEARRAY0:
-		case CREATEARRAY1:
+		vmcase(CREATEARRAY0)
+		vmcase(CREATEARRAY1)
 			task->aux -= CREATEARRAY0;
 			goto createarray;
-		case CREATEARRAY:
+		vmcase(CREATEARRAY)
 			task->aux = *task->pc++;
 createarray:
 			luaC_checkGC();
 			avalue(task->S->top) = luaH_new(task->aux);
 			ttype(task->S->top) = LUA_T_ARRAY;
 			task->S->top++;
-			break;
-		case EQOP:
-		case NEQOP:
+			vmbreak;
+		vmcase(EQOP)
+		vmcase(NEQOP)
 			{
 				int32 res = luaO_equalObj(task->S->top - 2, task->S->top - 1);
 				task->S->top--;
@@ -490,21 +634,21 @@ createarray:
 					res = !res;
 				ttype(task->S->top - 1) = res ? LUA_T_NUMBER : LUA_T_NIL;
 				nvalue(task->S->top - 1) = 1;
-				break;
+				vmbreak;
 			}
-		case LTOP:
+		vmcase(LTOP)
 			comparison(LUA_T_NUMBER, LUA_T_NIL, LUA_T_NIL, IM_LT);
-			break;
-		case LEOP:
+			vmbreak;
+		vmcase(LEOP)
 			comparison(LUA_T_NUMBER, LUA_T_NUMBER, LUA_T_NIL, IM_LE);
-			break;
-		case GTOP:
+			vmbreak;
+		vmcase(GTOP)
 			comparison(LUA_T_NIL, LUA_T_NIL, LUA_T_NUMBER, IM_GT);
-			break;
-		case GEOP:
+			vmbreak;
+		vmcase(GEOP)
 			comparison(LUA_T_NIL, LUA_T_NUMBER, LUA_T_NUMBER, IM_GE);
-			break;
-		case ADDOP:
+			vmbreak;
+		vmcase(ADDOP)
 			{
 				TObject *l = task->S->top - 2;
 				TObject *r = task->S->top - 1;
@@ -514,9 +658,9 @@ createarray:
 					nvalue(l) += nvalue(r);
 					--task->S->top;
 				}
-			break;
+			vmbreak;
 			}
-		case SUBOP:
+		vmcase(SUBOP)
 			{
 				TObject *l = task->S->top - 2;
 				TObject *r = task->S->top - 1;
@@ -526,9 +670,9 @@ createarray:
 					nvalue(l) -= nvalue(r);
 					--task->S->top;
 				}
-				break;
+				vmbreak;
 			}
-		case MULTOP:
+		vmcase(MULTOP)
 			{
 				TObject *l = task->S->top - 2;
 				TObject *r = task->S->top - 1;
@@ -538,9 +682,9 @@ createarray:
 					nvalue(l) *= nvalue(r);
 					--task->S->top;
 				}
-				break;
+				vmbreak;
 			}
-		case DIVOP:
+		vmcase(DIVOP)
 			{
 				TObject *l = task->S->top - 2;
 				TObject *r = task->S->top - 1;
@@ -550,12 +694,12 @@ createarray:
 					nvalue(l) /= nvalue(r);
 					--task->S->top;
 				}
-				break;
+				vmbreak;
 			}
-		case POWOP:
+		vmcase(POWOP)
 			call_arith(IM_POW);
-			break;
-		case CONCOP:
+			vmbreak;
+		vmcase(CONCOP)
 			{
 				TObject *l = task->S->top - 2;
 				TObject *r = task->S->top - 1;
@@ -566,106 +710,106 @@ createarray:
 					--task->S->top;
 				}
 				luaC_checkGC();
-				break;
+				vmbreak;
 			}
-		case MINUSOP:
+		vmcase(MINUSOP)
 			if (tonumber(task->S->top - 1)) {
 				ttype(task->S->top) = LUA_T_NIL;
 				task->S->top++;
 				call_arith(IM_UNM);
 			} else
 				nvalue(task->S->top - 1) = -nvalue(task->S->top - 1);
-			break;
-		case NOTOP:
+			vmbreak;
+		vmcase(NOTOP)
 			ttype(task->S->top - 1) = (ttype(task->S->top - 1) == LUA_T_NIL) ? LUA_T_NUMBER : LUA_T_NIL;
 			nvalue(task->S->top - 1) = 1;
-			break;
-		case ONTJMPW:
+			vmbreak;
+		vmcase(ONTJMPW)
 			task->aux = next_word(task->pc);
 			goto ontjmp;
-		case ONTJMP:
+		vmcase(ONTJMP)
 			task->aux = *task->pc++;
 ontjmp:
 			if (ttype(task->S->top - 1) != LUA_T_NIL)
 				task->pc += task->aux;
 			else
 				task->S->top--;
-			break;
-		case ONFJMPW:
+			vmbreak;
+		vmcase(ONFJMPW)
 			task->aux = next_word(task->pc);
 			goto onfjmp;
-		case ONFJMP:
+		vmcase(ONFJMP)
 			task->aux = *task->pc++;
 onfjmp:
 			if (ttype(task->S->top - 1) == LUA_T_NIL)
 				task->pc += task->aux;
 			else
 				task->S->top--;
-			break;
-		case JMPW:
+			vmbreak;
+		vmcase(JMPW)
 			task->aux = next_word(task->pc);
 			goto jmp;
-		case JMP:
+		vmcase(JMP)
 			task->aux = *task->pc++;
 jmp:
 			task->pc += task->aux;
-			break;
-		case IFFJMPW:
+			vmbreak;
+		vmcase(IFFJMPW)
 			task->aux = next_word(task->pc);
 			goto iffjmp;
-		case IFFJMP:
+		vmcase(IFFJMP)
 			task->aux = *task->pc++;
 iffjmp:
 			if (ttype(--task->S->top) == LUA_T_NIL)
 				task->pc += task->aux;
-			break;
-		case IFTUPJMPW:
+			vmbreak;
+		vmcase(IFTUPJMPW)
 			task->aux = next_word(task->pc);
 			goto iftupjmp;
-		case IFTUPJMP:
+		vmcase(IFTUPJMP)
 			task->aux = *task->pc++;
 iftupjmp:
 			if (ttype(--task->S->top) != LUA_T_NIL)
 				task->pc -= task->aux;
-			break;
-		case IFFUPJMPW:
+			vmbreak;
+		vmcase(IFFUPJMPW)
 			task->aux = next_word(task->pc);
 			goto iffupjmp;
-		case IFFUPJMP:
+		vmcase(IFFUPJMP)
 			task->aux = *task->pc++;
 iffupjmp:
 			if (ttype(--task->S->top) == LUA_T_NIL)
 				task->pc -= task->aux;
-			break;
-		case CLOSURE:
+			vmbreak;
+		vmcase(CLOSURE)
 			task->aux = *task->pc++;
 			goto closure;
-		case CLOSURE0:
-		case CLOSURE1:
+		vmcase(CLOSURE0)
+		vmcase(CLOSURE1)
 			task->aux -= CLOSURE0;
 closure:
 			luaV_closure(task->aux);
 			luaC_checkGC();
-			break;
-	  case CALLFUNC:
+			vmbreak;
+	  vmcase(CALLFUNC)
 			task->aux = *task->pc++;
 			goto callfunc;
-	  case CALLFUNC0:
-	  case CALLFUNC1:
+	  vmcase(CALLFUNC0)
+	  vmcase(CALLFUNC1)
 			task->aux -= CALLFUNC0;
 callfunc:
 			lua_state->state_counter2--;
 			return -((task->S->top - task->S->stack) - (*task->pc++));
-		case ENDCODE:
+		vmcase(ENDCODE)
 			task->S->top = task->S->stack + task->base;
 			// goes through
-		case RETCODE:
+		vmcase(RETCODE)
 			lua_state->state_counter2--;
 			return (task->base + ((task->aux == 123) ? *task->pc : 0));
-		case SETLINEW:
+		vmcase(SETLINEW)
 			task->aux = next_word(task->pc);
 			goto setline;
-		case SETLINE:
+		vmcase(SETLINE)
 			task->aux = *task->pc++;
 setline:
 			if ((task->S->stack + task->base - 1)->ttype != LUA_T_LINE) {
@@ -677,8 +821,8 @@ setline:
 			(task->S->stack + task->base - 1)->value.i = task->aux;
 			if (lua_linehook)
 				luaD_lineHook(task->aux);
-			break;
-#ifdef LUA_DEBUG
+			vmbreak;
+#if defined(LUA_DEBUG) && !defined(LUA_COMPUTED_GOTO)
 		default:
 			LUA_INTERNALERROR("internal error - opcode doesn't match");
 #endif
@@ -686,4 +830,20 @@ setline:
 	}
 }
 
+#ifdef LUA_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
+
+StkId luaV_execute(lua_Task *task) {
+	if (!profiling)
+		return execute(task, nullptr);
+
+	ProtoProfile *prof = getProfile(task->tf);
+	prof->calls++;
+	uint32 start = g_system->getMillis();
+	StkId result = execute(task, prof);
+	prof->msecs += g_system->getMillis() - start;
+	return result;
+}
+
 } // end of namespace Grim
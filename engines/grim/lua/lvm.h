@@ -24,6 +24,7 @@ void luaV_settable(TObject *t, int32 mode);
 void luaV_getglobal(TaggedString *ts);
 void luaV_setglobal(TaggedString *ts);
 void luaV_closure(int32 nelems);
+void luaV_forgetproto(TProtoFunc *tf);
 
 } // end of namespace Grim
 
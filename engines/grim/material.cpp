@@ -37,7 +37,7 @@ namespace Grim {
 Common::List<MaterialData *> *MaterialData::_materials = nullptr;
 
 MaterialData::MaterialData(const Common::String &filename, Common::SeekableReadStream *data, CMap *cmap) :
-		_fname(filename), _cmap(cmap), _refCount(1), _textures(nullptr) {
+		_fname(filename), _cmap(cmap), _numImages(0), _refCount(1), _textures(nullptr) {
 
 	if (g_grim->getGameType() == GType_MONKEY4) {
 		initEMI(data);
@@ -178,6 +178,10 @@ MaterialData::~MaterialData() {
 		_materials = nullptr;
 	}
 
+	freeTextures();
+}
+
+void MaterialData::freeTextures() {
 	for (int i = 0; i < _numImages; ++i) {
 		Texture *t = _textures[i];
 		if (!t) continue;
@@ -188,6 +192,25 @@ MaterialData::~MaterialData() {
 		delete t;
 	}
 	delete[] _textures;
+	_textures = nullptr;
+	_numImages = 0;
+}
+
+void MaterialData::releaseDriverData() {
+	freeTextures();
+}
+
+void MaterialData::createDriverData() {
+	if (_textures)
+		return;
+
+	Common::SeekableReadStream *data = g_resourceloader->openNewStreamFile(_fname.c_str(), true);
+	if (g_grim->getGameType() == GType_MONKEY4) {
+		initEMI(data);
+	} else if (data) {
+		initGrim(data);
+	}
+	delete data;
 }
 
 MaterialData *MaterialData::getMaterialData(const Common::String &filename, Common::SeekableReadStream *data, CMap *cmap) {
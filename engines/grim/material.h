@@ -49,6 +49,15 @@ public:
 	~MaterialData();
 
 	static MaterialData *getMaterialData(const Common::String &filename, Common::SeekableReadStream *data, CMap *cmap);
+
+	/**
+	 * Free the textures, including the driver side ones, so that the driver
+	 * can be replaced. createDriverData() reads the textures again, they get
+	 * uploaded to the new driver the next time they are selected.
+	 */
+	void releaseDriverData();
+	void createDriverData();
+
 	static Common::List<MaterialData *> *_materials;
 
 	Common::String _fname;
@@ -58,6 +67,7 @@ public:
 	int _refCount;
 
 private:
+	void freeTextures();
 	void initGrim(Common::SeekableReadStream *data);
 	void initEMI(Common::SeekableReadStream *data);
 };
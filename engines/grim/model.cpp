@@ -220,6 +220,20 @@ ModelNode *Model::getHierarchy() const {
 	return _rootHierNode;
 }
 
+void Model::releaseDriverData() {
+	for (int i = 0; i < _numHierNodes; ++i) {
+		if (_rootHierNode[i]._mesh)
+			g_driver->destroyMesh(_rootHierNode[i]._mesh);
+	}
+}
+
+void Model::createDriverData() {
+	for (int i = 0; i < _numHierNodes; ++i) {
+		if (_rootHierNode[i]._mesh)
+			g_driver->createMesh(_rootHierNode[i]._mesh);
+	}
+}
+
 void Model::reload(CMap *cmap) {
 	// Load the new colormap
 	for (int i = 0; i < _numMaterials; i++) {
@@ -47,6 +47,8 @@ public:
 
 	void reload(CMap *cmap);
 	void draw() const;
+	void releaseDriverData();
+	void createDriverData();
 	Material *findMaterial(const char *name, CMap *cmap) const;
 
 	~Model();
@@ -633,9 +633,9 @@ void Blocky16::init(int width, int height) {
 	// workaround for read over buffer by increasing buffer
 	// 200 bytes is enough for smush anims:
 	// lol, byeruba, crushed, eldepot, heltrain, hostage
-	uint32 deltaSize = size * 3 + 200;
-	_deltaBuf = new byte[deltaSize];
-	memset(_deltaBuf, 0, deltaSize);
+	_deltaSize = size * 3 + 200;
+	_deltaBuf = new byte[_deltaSize];
+	memset(_deltaBuf, 0, _deltaSize);
 	_deltaBufs[0] = _deltaBuf;
 	_deltaBufs[1] = _deltaBuf + _frameSize;
 	_curBuf = _deltaBuf + _frameSize * 2;
@@ -659,6 +659,7 @@ Blocky16::Blocky16() {
 	_height = _width = 0;
 	_offset = _offset1 = _offset2 = 0;
 	_frameSize = 0;
+	_deltaSize = 0;
 	_d_pitch = 0;
 }
 
@@ -846,4 +847,27 @@ void Blocky16::decode(byte *dst, const byte *src) {
 	_prevSeqNb = seq_nb;
 }
 
+uint32 Blocky16::getStateSize() const {
+	return 4 * sizeof(int32) + _deltaSize;
+}
+
+void Blocky16::saveState(byte *dst) const {
+	int32 *header = (int32 *)dst;
+	header[0] = _deltaBufs[0] - _deltaBuf;
+	header[1] = _deltaBufs[1] - _deltaBuf;
+	header[2] = _curBuf - _deltaBuf;
+	header[3] = _prevSeqNb;
+	memcpy(dst + 4 * sizeof(int32), _deltaBuf, _deltaSize);
+}
+
+void Blocky16::restoreState(const byte *src) {
+	const int32 *header = (const int32 *)src;
+	_deltaBufs[0] = _deltaBuf + header[0];
+	_deltaBufs[1] = _deltaBuf + header[1];
+	_curBuf = _deltaBuf + header[2];
+	_prevSeqNb = header[3];
+	memcpy(_deltaBuf, src + 4 * sizeof(int32), _deltaSize);
+	makeTables47(_width);
+}
+
 } // end of namespace Grim
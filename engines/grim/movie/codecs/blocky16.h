@@ -42,6 +42,7 @@ private:
 	byte *_tableSmall;
 	int16 _table[256];
 	int32 _frameSize;
+	uint32 _deltaSize;
 	int _offset;
 	int _width, _height;
 	int _blocksWidth, _blocksHeight;
@@ -59,6 +60,14 @@ public:
 	void init(int width, int height);
 	void deinit();
 	void decode(byte *dst, const byte *src);
+
+	/**
+	 * The decoding state is made of the buffers the next frames are decoded
+	 * against. Saving it allows to resume decoding from a later frame.
+	 */
+	uint32 getStateSize() const;
+	void saveState(byte *dst) const;
+	void restoreState(const byte *src);
 };
 
 } // end of namespace Grim
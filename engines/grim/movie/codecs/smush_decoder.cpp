@@ -45,6 +45,7 @@ namespace Grim {
 #define ANNO_HEADER "MakeAnim animation type 'Bl16' parameters: "
 #define BUFFER_SIZE 16385
 #define SMUSH_SPEED 66667
+#define SNAPSHOT_INTERVAL 64
 
 bool SmushDecoder::_demo = false;
 
@@ -60,12 +61,79 @@ SmushDecoder::SmushDecoder() {
 	_videoTrack = nullptr;
 	_audioTrack = nullptr;
 	_videoPause = false;
+
+	_snapshotsSize = 0;
+	_snapshotBudget = 0;
+	_snapshotInterval = SNAPSHOT_INTERVAL;
 }
 
 SmushDecoder::~SmushDecoder() {
 	delete _videoTrack;
 	delete _audioTrack;
 	delete[] _frames;
+	clearSnapshots();
+}
+
+void SmushDecoder::setSnapshotBudget(uint32 bytes) {
+	_snapshotBudget = bytes;
+	if (_snapshotsSize > _snapshotBudget)
+		clearSnapshots();
+}
+
+void SmushDecoder::clearSnapshots() {
+	for (uint i = 0; i < _snapshots.size(); i++) {
+		free(_snapshots[i].data);
+	}
+	_snapshots.clear();
+	_snapshotsSize = 0;
+	_snapshotInterval = SNAPSHOT_INTERVAL;
+}
+
+int SmushDecoder::findSnapshot(int frame) const {
+	// Index of the last snapshot at or before the frame
+	int found = -1;
+	for (uint i = 0; i < _snapshots.size() && _snapshots[i].frame <= frame; i++) {
+		found = i;
+	}
+	return found;
+}
+
+void SmushDecoder::takeSnapshot() {
+	int frame = _videoTrack->getCurFrame();
+	if (frame <= 0 || frame % _snapshotInterval != 0 || !_videoTrack->hasDecodedFrame())
+		return;
+
+	int index = findSnapshot(frame);
+	if (index >= 0 && _snapshots[index].frame == frame)
+		return;
+
+	uint32 size = _videoTrack->getStateSize();
+	if (_snapshotsSize + size > _snapshotBudget) {
+		// Out of memory: keep every other snapshot and take them half as often
+		_snapshotInterval *= 2;
+		for (uint i = 0; i < _snapshots.size();) {
+			if (_snapshots[i].frame % _snapshotInterval != 0) {
+				free(_snapshots[i].data);
+				_snapshotsSize -= size;
+				_snapshots.remove_at(i);
+			} else {
+				i++;
+			}
+		}
+
+		if (frame % _snapshotInterval != 0 || _snapshotsSize + size > _snapshotBudget)
+			return;
+		index = findSnapshot(frame);
+	}
+
+	Snapshot snapshot;
+	snapshot.frame = frame;
+	snapshot.data = (byte *)malloc(size);
+	if (!snapshot.data)
+		return;
+	_videoTrack->saveState(snapshot.data);
+	_snapshots.insert_at(index + 1, snapshot);
+	_snapshotsSize += size;
 }
 
 void SmushDecoder::init() {
@@ -125,6 +193,7 @@ void SmushDecoder::close() {
 	_startPos = 0;
 	delete[] _frames;
 	_frames = nullptr;
+	clearSnapshots();
 	if (_file) {
 		delete _file;
 		_file = nullptr;
@@ -269,6 +338,10 @@ bool SmushDecoder::loadStream(Common::SeekableReadStream *stream) {
 const Graphics::Surface *SmushDecoder::decodeNextFrame() {
 	handleFrame();
 
+	if (_snapshotBudget > 0 && _videoTrack->getStateSize() > 0) {
+		takeSnapshot();
+	}
+
 	// We might be interested in getting the last frame even after the video ends:
 	if (endOfVideo()) {
 		return _videoTrack->decodeNextFrame();
@@ -395,6 +468,8 @@ bool SmushDecoder::seekIntern(const Audio::Timestamp &time) {
 		initFrames();
 	}
 
+	uint32 startTime = g_system->getMillis();
+
 	// Track down the keyframe
 	int keyframe = 0;
 	for (int i = wantedFrame; i >= 0; --i) {
@@ -403,6 +478,14 @@ bool SmushDecoder::seekIntern(const Audio::Timestamp &time) {
 			break;
 		}
 	}
+
+	// Resume from the snapshot taken after a later frame, if any. The frames
+	// before it are still read for their audio, but aren't decoded.
+	int snapshot = findSnapshot(wantedFrame - 1);
+	if (snapshot >= 0 && _snapshots[snapshot].frame >= keyframe) {
+		_videoTrack->restoreState(_snapshots[snapshot].data);
+		keyframe = _snapshots[snapshot].frame + 1;
+	}
 	_videoTrack->setFrameStart(keyframe);
 
 	// VIMA frames are 50 frames ahead of time, so we have to make sure we have 50 frames
@@ -441,6 +524,8 @@ bool SmushDecoder::seekIntern(const Audio::Timestamp &time) {
 	int32 sampleCount = (delay.msecs() / 1000.f) * _audioTrack->getRate() - offset;
 	_audioTrack->skipSamples(sampleCount);
 
+	Debug::debug(Debug::Movie, "Seek to frame %d took %d ms, from frame %d", wantedFrame, g_system->getMillis() - startTime, keyframe);
+
 	VideoDecoder::seekIntern(time);
 	return true;
 }
@@ -587,6 +672,24 @@ Graphics::Surface *SmushDecoder::SmushVideoTrack::decodeNextFrame() {
 	return &_surface;
 }
 
+uint32 SmushDecoder::SmushVideoTrack::getStateSize() const {
+	// The demo videos are too short to need snapshots
+	if (!_is16Bit)
+		return 0;
+
+	return _blocky16->getStateSize() + _surface.h * _surface.pitch;
+}
+
+void SmushDecoder::SmushVideoTrack::saveState(byte *dst) const {
+	_blocky16->saveState(dst);
+	memcpy(dst + _blocky16->getStateSize(), _surface.getPixels(), _surface.h * _surface.pitch);
+}
+
+void SmushDecoder::SmushVideoTrack::restoreState(const byte *src) {
+	_blocky16->restoreState(src);
+	memcpy(_surface.getPixels(), src + _blocky16->getStateSize(), _surface.h * _surface.pitch);
+}
+
 void SmushDecoder::SmushVideoTrack::setMsPerFrame(int ms) {
 	_frameRate = Common::Rational(1000000, ms);
 }
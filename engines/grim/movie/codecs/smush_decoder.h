@@ -23,6 +23,8 @@
 #ifndef GRIM_SMUSH_DECODER_H
 #define GRIM_SMUSH_DECODER_H
 
+#include "common/array.h"
+
 #include "audio/audiostream.h"
 
 #include "video/video_decoder.h"
@@ -53,6 +55,12 @@ public:
 	bool seekIntern(const Audio::Timestamp &time) override;
 	bool loadStream(Common::SeekableReadStream *stream) override;
 
+	/**
+	 * Sets the memory the decoder may use to keep snapshots of its state
+	 * while playing, which seeking resumes from. 0 disables the snapshots.
+	 */
+	void setSnapshotBudget(uint32 bytes);
+
 protected:
 	bool readHeader();
 	void handleFrameDemo();
@@ -89,6 +97,11 @@ protected:
 
 		byte *getPal() { return _pal; }
 		int _x, _y;
+
+		bool hasDecodedFrame() const { return _curFrame > _frameStart; }
+		uint32 getStateSize() const;
+		void saveState(byte *dst) const;
+		void restoreState(const byte *src);
 	private:
 		void convertDemoFrame();
 		bool _is16Bit;
@@ -130,6 +143,9 @@ protected:
 	};
 private:
 	void initFrames();
+	void takeSnapshot();
+	int findSnapshot(int frame) const;
+	void clearSnapshots();
 
 	SmushAudioTrack *_audioTrack;
 	SmushVideoTrack *_videoTrack;
@@ -146,6 +162,17 @@ private:
 		bool keyframe;
 	};
 	Frame *_frames;
+
+	// Decoder state after decoding a frame, taken every _snapshotInterval frames
+	struct Snapshot {
+		int frame;
+		byte *data;
+	};
+	Common::Array<Snapshot> _snapshots;
+	uint32 _snapshotsSize;
+	uint32 _snapshotBudget;
+	int _snapshotInterval;
+
 	static bool _demo;
 };
 
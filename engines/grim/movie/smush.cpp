@@ -20,6 +20,8 @@
  *
  */
 
+#include "common/config-manager.h"
+
 #include "engines/grim/movie/codecs/smush_decoder.h"
 #include "engines/grim/movie/smush.h"
 
@@ -34,6 +36,7 @@ MoviePlayer *CreateSmushPlayer(bool demo) {
 
 SmushPlayer::SmushPlayer(bool demo) : MoviePlayer(), _demo(demo) {
 	_smushDecoder = new SmushDecoder();
+	_smushDecoder->setSnapshotBudget(ConfMan.getInt("movie_seek_cache_size") * 1024);
 	_videoDecoder = _smushDecoder;
 	//_smushDecoder->setDemo(_demo);
 }
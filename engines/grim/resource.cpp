@@ -71,8 +71,12 @@ public:
 };
 
 ResourceLoader::ResourceLoader() {
-	_cacheDirty = false;
 	_cacheMemorySize = 0;
+	_cacheBudget = ConfMan.getInt("resource_cache_size") * 1024;
+	_cacheHits = 0;
+	_cacheMisses = 0;
+	_cacheEvictions = 0;
+	_cacheEvictedBytes = 0;
 
 	Lab *l;
 	Common::ArchiveMemberList files, updFiles;
@@ -224,11 +228,6 @@ void clearList(Common::List<T> &list) {
 }
 
 ResourceLoader::~ResourceLoader() {
-	for (Common::Array<ResourceCache>::iterator i = _cache.begin(); i != _cache.end(); ++i) {
-		ResourceCache &r = *i;
-		delete[] r.fname;
-		delete[] r.resPtr;
-	}
 	clearList(_models);
 	clearList(_colormaps);
 	clearList(_keyframeAnims);
@@ -236,32 +235,29 @@ ResourceLoader::~ResourceLoader() {
 	MD5Check::clear();
 }
 
-static int sortCallback(const void *entry1, const void *entry2) {
-	return scumm_stricmp(((const ResourceLoader::ResourceCache *)entry1)->fname, ((const ResourceLoader::ResourceCache *)entry2)->fname);
-}
+struct CacheDataDeleter {
+	void operator()(byte *data) { delete[] data; }
+};
 
 Common::SeekableReadStream *ResourceLoader::getFileFromCache(const Common::String &filename) const {
-	ResourceLoader::ResourceCache *entry = getEntryFromCache(filename);
-	if (!entry)
-		return nullptr;
-
-	return new Common::MemoryReadStream(entry->resPtr, entry->len);
-
-}
-
-ResourceLoader::ResourceCache *ResourceLoader::getEntryFromCache(const Common::String &filename) const {
-	if (_cache.empty())
+	CacheIndex::iterator it = _cacheIndex.find(filename);
+	if (it == _cacheIndex.end()) {
+		++_cacheMisses;
 		return nullptr;
-
-	if (_cacheDirty) {
-		qsort(_cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
-		_cacheDirty = false;
+	}
+	++_cacheHits;
+
+	// Move the entry to the front of the list, it is now the most recently used one.
+	CacheList::iterator entry = it->_value;
+	if (entry != _cache.begin()) {
+		_cache.push_front(*entry);
+		_cache.erase(entry);
+		it->_value = _cache.begin();
 	}
 
-	ResourceCache key;
-	key.fname = const_cast<char *>(filename.c_str());
-
-	return (ResourceLoader::ResourceCache *)bsearch(&key, _cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
+	// The stream keeps its own reference to the data, so that evicting the entry does not invalidate it.
+	const ResourceCache &r = _cache.front();
+	return new Common::SharedMemoryReadStream(r.resPtr, 0, r.len);
 }
 
 Common::SeekableReadStream *ResourceLoader::loadFile(const Common::String &filename) const {
@@ -289,9 +285,10 @@ Common::SeekableReadStream *ResourceLoader::openNewStreamFile(Common::String fna
 			uint32 size = s->size();
 			byte *buf = new byte[size];
 			s->read(buf, size);
-			putIntoCache(fname, buf, size);
+			Common::SharedPtr<byte> data(buf, CacheDataDeleter());
+			putIntoCache(fname, data, size);
 			delete s;
-			s = new Common::MemoryReadStream(buf, size);
+			s = new Common::SharedMemoryReadStream(data, 0, size);
 		}
 	} else {
 		s = loadFile(fname);
@@ -300,15 +297,45 @@ Common::SeekableReadStream *ResourceLoader::openNewStreamFile(Common::String fna
 	return Common::wrapCompressedReadStream(s);
 }
 
-void ResourceLoader::putIntoCache(const Common::String &fname, byte *res, uint32 len) const {
+void ResourceLoader::putIntoCache(const Common::String &fname, const Common::SharedPtr<byte> &res, uint32 len) const {
 	ResourceCache entry;
+	entry.fname = fname;
 	entry.resPtr = res;
 	entry.len = len;
-	entry.fname = new char[fname.size() + 1];
-	strcpy(entry.fname, fname.c_str());
 	_cacheMemorySize += len;
-	_cache.push_back(entry);
-	_cacheDirty = true;
+	_cache.push_front(entry);
+	_cacheIndex[fname] = _cache.begin();
+
+	evictFromCache(_cacheBudget);
+}
+
+void ResourceLoader::evictFromCache(uint32 budget) const {
+	// The most recently used entry is always kept, even if it is bigger than the budget on its own.
+	while (_cacheMemorySize > budget && _cache.size() > 1) {
+		const ResourceCache &r = _cache.back();
+		_cacheMemorySize -= r.len;
+		++_cacheEvictions;
+		_cacheEvictedBytes += r.len;
+		_cacheIndex.erase(r.fname);
+		_cache.pop_back();
+	}
+}
+
+void ResourceLoader::setCacheBudget(uint32 bytes) {
+	_cacheBudget = bytes;
+	evictFromCache(_cacheBudget);
+}
+
+ResourceLoader::CacheStats ResourceLoader::getCacheStats() const {
+	CacheStats stats;
+	stats.entries = _cacheIndex.size();
+	stats.memorySize = _cacheMemorySize;
+	stats.budget = _cacheBudget;
+	stats.hits = _cacheHits;
+	stats.misses = _cacheMisses;
+	stats.evictions = _cacheEvictions;
+	stats.evictedBytes = _cacheEvictedBytes;
+	return stats;
 }
 
 CMap *ResourceLoader::loadColormap(const Common::String &filename) {
@@ -522,19 +549,11 @@ void ResourceLoader::uncache(const char *filename) const {
 	Common::String fname = filename;
 	fname.toLowercase();
 
-	if (_cacheDirty) {
-		qsort(_cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
-		_cacheDirty = false;
-	}
-
-	for (unsigned int i = 0; i < _cache.size(); i++) {
-		if (fname.compareTo(_cache[i].fname) == 0) {
-			delete[] _cache[i].fname;
-			_cacheMemorySize -= _cache[i].len;
-			delete[] _cache[i].resPtr;
-			_cache.remove_at(i);
-			_cacheDirty = true;
-		}
+	CacheIndex::iterator it = _cacheIndex.find(fname);
+	if (it != _cacheIndex.end()) {
+		_cacheMemorySize -= it->_value->len;
+		_cache.erase(it->_value);
+		_cacheIndex.erase(it);
 	}
 }
 
@@ -542,6 +561,10 @@ void ResourceLoader::uncacheModel(Model *m) {
 	_models.remove(m);
 }
 
+void ResourceLoader::uncacheModelEmi(EMIModel *m) {
+	_emiModels.remove(m);
+}
+
 void ResourceLoader::uncacheColormap(CMap *c) {
 	_colormaps.remove(c);
 }
@@ -558,6 +581,34 @@ void ResourceLoader::uncacheAnimationEmi(AnimationEmi *a) {
 	_emiAnims.remove(a);
 }
 
+void ResourceLoader::releaseDriverData() {
+	for (Common::List<Model *>::const_iterator i = _models.begin(); i != _models.end(); ++i) {
+		(*i)->releaseDriverData();
+	}
+	for (Common::List<EMIModel *>::const_iterator i = _emiModels.begin(); i != _emiModels.end(); ++i) {
+		(*i)->releaseDriverData();
+	}
+	if (MaterialData::_materials) {
+		for (Common::List<MaterialData *>::const_iterator i = MaterialData::_materials->begin(); i != MaterialData::_materials->end(); ++i) {
+			(*i)->releaseDriverData();
+		}
+	}
+}
+
+void ResourceLoader::createDriverData() {
+	for (Common::List<Model *>::const_iterator i = _models.begin(); i != _models.end(); ++i) {
+		(*i)->createDriverData();
+	}
+	for (Common::List<EMIModel *>::const_iterator i = _emiModels.begin(); i != _emiModels.end(); ++i) {
+		(*i)->createDriverData();
+	}
+	if (MaterialData::_materials) {
+		for (Common::List<MaterialData *>::const_iterator i = MaterialData::_materials->begin(); i != MaterialData::_materials->end(); ++i) {
+			(*i)->createDriverData();
+		}
+	}
+}
+
 ModelPtr ResourceLoader::getModel(const Common::String &fname, CMap *c) {
 	Common::String filename = fname;
 	filename.toLowercase();
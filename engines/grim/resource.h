@@ -25,6 +25,9 @@
 
 #include "common/archive.h"
 #include "common/array.h"
+#include "common/hash-str.h"
+#include "common/list.h"
+#include "common/ptr.h"
 
 #include "engines/grim/object.h"
 
@@ -79,29 +82,57 @@ public:
 	LipSyncPtr getLipSync(const Common::String &fname);
 	AnimationEmiPtr getAnimationEmi(const Common::String &fname);
 	void uncacheModel(Model *m);
+	void uncacheModelEmi(EMIModel *m);
 	void uncacheColormap(CMap *c);
 	void uncacheKeyframe(KeyframeAnim *kf);
 	void uncacheLipSync(LipSync *l);
 	void uncacheAnimationEmi(AnimationEmi *a);
 
+	/** Releases and recreates the driver data of the loaded models, EMI models and materials. */
+	void releaseDriverData();
+	void createDriverData();
+
 	struct ResourceCache {
-		char *fname;
-		byte *resPtr;
+		Common::String fname;
+		Common::SharedPtr<byte> resPtr;
 		uint32 len;
 	};
 
+	struct CacheStats {
+		uint32 entries;
+		uint32 memorySize;
+		uint32 budget;
+		uint32 hits;
+		uint32 misses;
+		uint32 evictions;
+		uint32 evictedBytes;
+	};
+
+	/** Sets the maximum number of bytes kept in the file cache, evicting the least recently used files. */
+	void setCacheBudget(uint32 bytes);
+	CacheStats getCacheStats() const;
+
 	static Common::String fixFilename(const Common::String &filename, bool append = true);
 
 private:
 	Common::SeekableReadStream *loadFile(const Common::String &filename) const;
 	Common::SeekableReadStream *getFileFromCache(const Common::String &filename) const;
-	ResourceLoader::ResourceCache *getEntryFromCache(const Common::String &filename) const;
-	void putIntoCache(const Common::String &fname, byte *res, uint32 len) const;
+	void putIntoCache(const Common::String &fname, const Common::SharedPtr<byte> &res, uint32 len) const;
 	void uncache(const char *fname) const;
-
-	mutable Common::Array<ResourceCache> _cache;
-	mutable bool _cacheDirty;
-	mutable int32 _cacheMemorySize;
+	void evictFromCache(uint32 budget) const;
+
+	typedef Common::List<ResourceCache> CacheList;
+	typedef Common::HashMap<Common::String, CacheList::iterator> CacheIndex;
+
+	// Cached files, most recently used first.
+	mutable CacheList _cache;
+	mutable CacheIndex _cacheIndex;
+	mutable uint32 _cacheMemorySize;
+	uint32 _cacheBudget;
+	mutable uint32 _cacheHits;
+	mutable uint32 _cacheMisses;
+	mutable uint32 _cacheEvictions;
+	mutable uint32 _cacheEvictedBytes;
 
 	Common::List<EMIModel *> _emiModels;
 	Common::List<Model *> _models;
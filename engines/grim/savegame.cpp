@@ -33,9 +33,13 @@ namespace Grim {
 
 #define SAVEGAME_HEADERTAG  'RSAV'
 #define SAVEGAME_FOOTERTAG  'ESAV'
+#define SAVEGAME_DIRECTORYTAG 'SDIR'
+
+// Minor version since which the section directory is written
+#define SAVEGAME_DIRECTORY_VERSION 27
 
 uint SaveGame::SAVEGAME_MAJOR_VERSION = 22;
-uint SaveGame::SAVEGAME_MINOR_VERSION = 26;
+uint SaveGame::SAVEGAME_MINOR_VERSION = 27;
 
 SaveGame *SaveGame::openForLoading(const Common::String &filename) {
 	Common::InSaveFile *inSaveFile = g_system->getSavefileManager()->openForLoading(filename);
@@ -57,6 +61,11 @@ SaveGame *SaveGame::openForLoading(const Common::String &filename) {
 	save->_majorVersion = inSaveFile->readUint32BE();
 	save->_minorVersion = inSaveFile->readUint32BE();
 
+	// The directory is only read when a section is not found by reading
+	// on, since compressed saves have to be inflated to reach the end
+	save->_directoryPending = save->_majorVersion == SAVEGAME_MAJOR_VERSION &&
+	                          save->_minorVersion >= SAVEGAME_DIRECTORY_VERSION;
+
 	return save;
 }
 
@@ -78,6 +87,7 @@ SaveGame *SaveGame::openForSaving(const Common::String &filename) {
 
 	save->_majorVersion = SAVEGAME_MAJOR_VERSION;
 	save->_minorVersion = SAVEGAME_MINOR_VERSION;
+	save->_fileSize = 12;
 
 	return save;
 }
@@ -85,13 +95,14 @@ SaveGame *SaveGame::openForSaving(const Common::String &filename) {
 SaveGame::SaveGame() :
 		_currentSection(0), _sectionBuffer(nullptr), _majorVersion(0),
 		_minorVersion(0), _saving(false), _inSaveFile(nullptr), _outSaveFile(nullptr),
-		_sectionSize(0), _sectionAlloc(0), _sectionPtr(0) {
+		_sectionSize(0), _sectionAlloc(0), _sectionPtr(0), _directoryPending(false),
+		_fileSize(0) {
 
 }
 
 SaveGame::~SaveGame() {
 	if (_saving) {
-		_outSaveFile->writeUint32BE(SAVEGAME_FOOTERTAG);
+		writeDirectory();
 		_outSaveFile->finalize();
 		if (_outSaveFile->err())
 			warning("SaveGame::~SaveGame() Can't write file. (Disk full?)");
@@ -122,14 +133,20 @@ uint32 SaveGame::beginSection(uint32 sectionTag) {
 	_currentSection = sectionTag;
 	_sectionSize = 0;
 	if (!_saving) {
-		uint32 tag = 0;
-
-		while (tag != sectionTag) {
-			tag = _inSaveFile->readUint32BE();
-			if (tag == SAVEGAME_FOOTERTAG)
+		if (_sectionOffsets.empty() && !findNextSection(sectionTag)) {
+			if (_directoryPending)
+				readDirectory();
+			if (_sectionOffsets.empty())
 				error("Unable to find requested section of savegame");
+		}
+		if (!_sectionOffsets.empty()) {
+			// Jump straight to the section, in any order
+			if (!_sectionOffsets.contains(sectionTag))
+				error("Unable to find requested section of savegame");
+			_inSaveFile->seek(_sectionOffsets[sectionTag], SEEK_SET);
+			if (_inSaveFile->readUint32BE() != sectionTag)
+				error("Savegame section directory is corrupt");
 			_sectionSize = _inSaveFile->readUint32BE();
-			_inSaveFile->seek(_sectionSize, SEEK_CUR);
 		}
 		if (!_sectionBuffer || _sectionAlloc < _sectionSize) {
 			_sectionAlloc = _sectionSize;
@@ -141,7 +158,6 @@ uint32 SaveGame::beginSection(uint32 sectionTag) {
 			_sectionBuffer = buff;
 		}
 
-		_inSaveFile->seek(-(int32)_sectionSize, SEEK_CUR);
 		_inSaveFile->read(_sectionBuffer, _sectionSize);
 
 	} else {
@@ -158,13 +174,86 @@ void SaveGame::endSection() {
 	if (_currentSection == 0)
 		error("Tried to end a save game section without starting a section");
 	if (_saving) {
+		if (!_sectionOffsets.contains(_currentSection))
+			_sectionOffsets[_currentSection] = _fileSize;
 		_outSaveFile->writeUint32BE(_currentSection);
 		_outSaveFile->writeUint32BE(_sectionSize);
 		_outSaveFile->write(_sectionBuffer, _sectionSize);
+		_fileSize += 8 + _sectionSize;
 	}
 	_currentSection = 0;
 }
 
+/*
+ * The directory is written as the last section, so older builds skip it like
+ * any unknown section. The footer tag is followed by the directory offset and
+ * tag again, which lets the loader find it from the end of the file.
+ * writeDirectory() therefore also writes the footer.
+ */
+void SaveGame::writeDirectory() {
+	uint32 offset = _fileSize;
+	_outSaveFile->writeUint32BE(SAVEGAME_DIRECTORYTAG);
+	_outSaveFile->writeUint32BE(4 + _sectionOffsets.size() * 8);
+	_outSaveFile->writeUint32BE(_sectionOffsets.size());
+	for (Common::HashMap<uint32, uint32>::const_iterator i = _sectionOffsets.begin(); i != _sectionOffsets.end(); ++i) {
+		_outSaveFile->writeUint32BE(i->_key);
+		_outSaveFile->writeUint32BE(i->_value);
+	}
+	_fileSize += 12 + _sectionOffsets.size() * 8;
+	_outSaveFile->writeUint32BE(SAVEGAME_FOOTERTAG);
+	_outSaveFile->writeUint32BE(offset);
+	_outSaveFile->writeUint32BE(SAVEGAME_DIRECTORYTAG);
+}
+
+/*
+ * Sections are mostly loaded in the order they were written, so they are
+ * first looked for from the current position on. On success the stream is
+ * left at the start of the section data, otherwise somewhere past it.
+ */
+bool SaveGame::findNextSection(uint32 sectionTag) {
+	uint32 tag = 0;
+
+	while (tag != sectionTag) {
+		tag = _inSaveFile->readUint32BE();
+		if (tag == SAVEGAME_FOOTERTAG || _inSaveFile->eos())
+			return false;
+		_sectionSize = _inSaveFile->readUint32BE();
+		_inSaveFile->seek(_sectionSize, SEEK_CUR);
+	}
+	_inSaveFile->seek(-(int32)_sectionSize, SEEK_CUR);
+	return true;
+}
+
+void SaveGame::readDirectory() {
+	_directoryPending = false;
+
+	int32 size = _inSaveFile->size();
+	if (size < 24) {
+		warning("SaveGame::readDirectory() Savegame is too short for a section directory");
+		return;
+	}
+
+	_inSaveFile->seek(size - 8, SEEK_SET);
+	uint32 offset = _inSaveFile->readUint32BE();
+	uint32 tag = _inSaveFile->readUint32BE();
+	if (tag == SAVEGAME_DIRECTORYTAG && offset < (uint32)size) {
+		_inSaveFile->seek(offset, SEEK_SET);
+		if (_inSaveFile->readUint32BE() == SAVEGAME_DIRECTORYTAG) {
+			_inSaveFile->readUint32BE();
+			uint32 count = _inSaveFile->readUint32BE();
+			for (uint32 i = 0; i < count && !_inSaveFile->eos(); i++) {
+				uint32 sectionTag = _inSaveFile->readUint32BE();
+				_sectionOffsets[sectionTag] = _inSaveFile->readUint32BE();
+			}
+			if (_inSaveFile->eos() || _inSaveFile->err())
+				_sectionOffsets.clear();
+		}
+	}
+
+	if (_sectionOffsets.empty())
+		warning("SaveGame::readDirectory() No section directory found");
+}
+
 void SaveGame::read(void *data, int size) {
 	if (_saving)
 		error("SaveGame::readBlock called when storing a savegame");
@@ -23,6 +23,8 @@
 #ifndef GRIM_SAVEGAME_H
 #define GRIM_SAVEGAME_H
 
+#include "common/hashmap.h"
+
 #include "math/mathfwd.h"
 
 namespace Common {
@@ -90,6 +92,10 @@ public:
 protected:
 	SaveGame();
 
+	bool findNextSection(uint32 sectionTag);
+	void readDirectory();
+	void writeDirectory();
+
 	uint _majorVersion;
 	uint _minorVersion;
 	bool _saving;
@@ -100,6 +106,10 @@ protected:
 	uint32 _sectionAlloc;
 	uint32 _sectionPtr;
 	byte *_sectionBuffer;
+	// Offset of every section in the file, from the directory at its end
+	Common::HashMap<uint32, uint32> _sectionOffsets;
+	bool _directoryPending;
+	uint32 _fileSize;
 
 	static const int _allocAmmount = 1048576;
 };
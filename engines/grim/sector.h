@@ -66,6 +66,7 @@ public:
 	int getSectorId() const { return _id; }
 	SectorType getType() const { return _type; } // FIXME: Implement type de-masking
 	bool isVisible() const { return _visible && !_invalid; }
+	float getHeight() const { return _height; }
 	bool isPointInSector(const Math::Vector3d &point) const;
 	float distanceToPoint(const Math::Vector3d &point) const;
 	Common::List<Math::Line3d> getBridgesTo(Sector *sector) const;
@@ -40,7 +40,8 @@
 namespace Grim {
 
 Set::Set(const Common::String &sceneName, Common::SeekableReadStream *data) :
-		_locked(false), _name(sceneName), _enableLights(false) {
+		_locked(false), _name(sceneName), _enableLights(false), _sectorLinksValid(false),
+		_sectorGridValid(false) {
 
 	char header[7];
 	data->read(header, 7);
@@ -58,7 +59,8 @@ Set::Set() :
 		_cmaps(nullptr), _locked(false), _enableLights(false), _numSetups(0),
 		_numLights(0), _numSectors(0), _numObjectStates(0), _minVolume(0),
 		_maxVolume(0), _numCmaps(0), _numShadows(0), _currSetup(nullptr),
-		_setups(nullptr), _lights(nullptr), _sectors(nullptr), _shadows(nullptr) {
+		_setups(nullptr), _lights(nullptr), _sectors(nullptr), _shadows(nullptr),
+		_sectorLinksValid(false), _sectorGridValid(false) {
 
 	setupOverworldLights();
 }
@@ -331,6 +333,7 @@ bool Set::restoreState(SaveGame *savedState) {
 	} else {
 		_sectors = nullptr;
 	}
+	invalidateSectorCaches();
 
 	_numLights = savedState->readLESint32();
 	_lights = new Light[_numLights];
@@ -891,8 +894,9 @@ void Set::setupCamera() {
 }
 
 Sector *Set::findPointSector(const Math::Vector3d &p, Sector::SectorType type) {
-	for (int i = 0; i < _numSectors; i++) {
-		Sector *sector = _sectors[i];
+	const Common::Array<int> &candidates = getSectorCandidates(p);
+	for (uint i = 0; i < candidates.size(); i++) {
+		Sector *sector = _sectors[candidates[i]];
 		if (sector && (sector->getType() & type) && sector->isVisible() && sector->isPointInSector(p))
 			return sector;
 	}
@@ -904,8 +908,10 @@ int Set::findSectorSortOrder(const Math::Vector3d &p, Sector::SectorType type) {
 	int sortOrder = 0;
 	float minDist = 0.01f;
 
-	for (int i = 0; i < _numSectors; i++) {
-		Sector *sector = _sectors[i];
+	// The sectors closer than minDist are all candidates of the point's cell
+	const Common::Array<int> &candidates = getSectorCandidates(p);
+	for (uint i = 0; i < candidates.size(); i++) {
+		Sector *sector = _sectors[candidates[i]];
 		if (!sector || (sector->getType() & type) == 0 || !sector->isVisible() || setup >= sector->getNumSortplanes())
 			continue;
 
@@ -919,19 +925,56 @@ int Set::findSectorSortOrder(const Math::Vector3d &p, Sector::SectorType type) {
 	return sortOrder;
 }
 
+static void getGroundCoords(const Math::Vector3d &p, float &x, float &y) {
+	x = p.x();
+	y = g_grim->getGameType() == GType_MONKEY4 ? p.z() : p.y();
+}
+
 void Set::findClosestSector(const Math::Vector3d &p, Sector **sect, Math::Vector3d *closestPoint) {
 	Sector *resultSect = nullptr;
+	int resultIndex = -1;
 	Math::Vector3d resultPt = p;
 	float minDist = 0.0;
 
-	for (int i = 0; i < _numSectors; i++) {
-		Sector *sector = _sectors[i];
+	// Start with the sectors around the point to get a small distance
+	// early, which lets the bounding boxes reject most of the others.
+	const Common::Array<int> &candidates = getSectorCandidates(p);
+	for (uint i = 0; i < candidates.size(); i++) {
+		Sector *sector = _sectors[candidates[i]];
 		if ((sector->getType() & Sector::WalkType) == 0 || !sector->isVisible())
 			continue;
 		Math::Vector3d closestPt = sector->getClosestPoint(p);
 		float thisDist = (closestPt - p).getMagnitude();
 		if (!resultSect || thisDist < minDist) {
 			resultSect = sector;
+			resultIndex = candidates[i];
+			resultPt = closestPt;
+			minDist = thisDist;
+		}
+	}
+
+	float x, y;
+	getGroundCoords(p, x, y);
+	for (int i = 0; i < _numSectors; i++) {
+		Sector *sector = _sectors[i];
+		if ((sector->getType() & Sector::WalkType) == 0 || !sector->isVisible() || i == resultIndex)
+			continue;
+
+		// The closest point lies in the bounding box of the vertices
+		if (resultSect) {
+			const SectorBounds &bounds = _sectorBounds[i];
+			float dx = MAX(MAX(bounds.minX - x, x - bounds.maxX), 0.f);
+			float dy = MAX(MAX(bounds.minY - y, y - bounds.maxY), 0.f);
+			if (dx * dx + dy * dy > minDist * minDist)
+				continue;
+		}
+
+		Math::Vector3d closestPt = sector->getClosestPoint(p);
+		float thisDist = (closestPt - p).getMagnitude();
+		// On a tie keep the sector coming first, as a plain scan would
+		if (!resultSect || thisDist < minDist || (thisDist == minDist && i < resultIndex)) {
+			resultSect = sector;
+			resultIndex = i;
 			resultPt = closestPt;
 			minDist = thisDist;
 		}
@@ -949,6 +992,7 @@ void Set::shrinkBoxes(float radius) {
 		Sector *sector = _sectors[i];
 		sector->shrink(radius);
 	}
+	invalidateSectorCaches();
 }
 
 void Set::unshrinkBoxes() {
@@ -956,6 +1000,183 @@ void Set::unshrinkBoxes() {
 		Sector *sector = _sectors[i];
 		sector->unshrink();
 	}
+	invalidateSectorCaches();
+}
+
+static bool isPathSector(const Sector *sector) {
+	int type = sector->getType();
+	return type == Sector::WalkType || type == Sector::HotType || type == Sector::FunnelType;
+}
+
+void Set::buildSectorLinks() {
+	_sectorLinks.clear();
+	_sectorLinks.resize(MAX(_numSectors, 0));
+
+	// The bridges only depend on the shape of the sectors, so the visibility
+	// is left to be checked by the path finding.
+	for (int i = 0; i < _numSectors; i++) {
+		Sector *sector = _sectors[i];
+		if (!isPathSector(sector) && (sector->getType() & Sector::WalkType) == 0)
+			continue;
+
+		for (int j = 0; j < _numSectors; j++) {
+			if (i == j || !isPathSector(_sectors[j]))
+				continue;
+
+			Common::List<Math::Line3d> bridges = sector->getBridgesTo(_sectors[j]);
+			if (bridges.empty())
+				continue;
+
+			SectorLink link;
+			link.sector = j;
+			for (Common::List<Math::Line3d>::const_iterator k = bridges.begin(); k != bridges.end(); ++k)
+				link.bridges.push_back(*k);
+			_sectorLinks[i].push_back(link);
+		}
+	}
+
+	_sectorLinksValid = true;
+}
+
+const Common::Array<Set::SectorLink> &Set::getSectorLinks(int id) {
+	if (!_sectorLinksValid)
+		buildSectorLinks();
+	return _sectorLinks[id];
+}
+
+int Set::getSectorIndex(const Sector *sector) const {
+	for (int i = 0; i < _numSectors; i++) {
+		if (_sectors[i] == sector)
+			return i;
+	}
+	return -1;
+}
+
+void Set::buildSectorGrid() {
+	const int gridSize = kSectorGridSize;
+	// Margin for the tolerance of the sector point tests
+	const float margin = 0.01f;
+
+	_sectorBounds.clear();
+	_sectorGrid.clear();
+	_unboundedSectors.clear();
+
+	Common::Array<SectorBounds> queryBounds;
+	SectorBounds &gridBounds = _sectorGridBounds;
+	bool hasBounds = false;
+	for (int i = 0; i < _numSectors; i++) {
+		Sector *sector = _sectors[i];
+		Math::Vector3d *vertices = sector->getVertices();
+
+		SectorBounds bounds;
+		if (sector->getNumVertices() == 0) {
+			bounds.minX = bounds.minY = bounds.maxX = bounds.maxY = 0.f;
+			_sectorBounds.push_back(bounds);
+			_unboundedSectors.push_back(i);
+			queryBounds.push_back(bounds);
+			continue;
+		}
+		getGroundCoords(vertices[0], bounds.minX, bounds.minY);
+		bounds.maxX = bounds.minX;
+		bounds.maxY = bounds.minY;
+		for (int j = 1; j < sector->getNumVertices(); j++) {
+			float x, y;
+			getGroundCoords(vertices[j], x, y);
+			bounds.minX = MIN(bounds.minX, x);
+			bounds.minY = MIN(bounds.minY, y);
+			bounds.maxX = MAX(bounds.maxX, x);
+			bounds.maxY = MAX(bounds.maxY, y);
+		}
+		_sectorBounds.push_back(bounds);
+
+		// A point is tested against the polygon projected along the normal,
+		// so a sloped sector covers more ground within its height.
+		Math::Vector3d normal = sector->getNormal();
+		float normalX, normalY;
+		getGroundCoords(normal, normalX, normalY);
+		float slope = sqrt(normalX * normalX + normalY * normalY);
+		float normalLength = normal.getMagnitude();
+		if (normalLength > 0.f)
+			slope /= normalLength;
+
+		float expand = margin;
+		if (slope > 0.0001f) {
+			if (sector->getHeight() >= 9000.f) {
+				_unboundedSectors.push_back(i);
+				queryBounds.push_back(bounds);
+				continue;
+			}
+			expand += (sector->getHeight() + 0.01f) * slope;
+		}
+
+		bounds.minX -= expand;
+		bounds.minY -= expand;
+		bounds.maxX += expand;
+		bounds.maxY += expand;
+		queryBounds.push_back(bounds);
+
+		if (!hasBounds) {
+			gridBounds = bounds;
+			hasBounds = true;
+		} else {
+			gridBounds.minX = MIN(gridBounds.minX, bounds.minX);
+			gridBounds.minY = MIN(gridBounds.minY, bounds.minY);
+			gridBounds.maxX = MAX(gridBounds.maxX, bounds.maxX);
+			gridBounds.maxY = MAX(gridBounds.maxY, bounds.maxY);
+		}
+	}
+
+	if (!hasBounds) {
+		gridBounds.minX = gridBounds.minY = 0.f;
+		gridBounds.maxX = gridBounds.maxY = 0.f;
+	}
+	_sectorGridCellWidth = MAX((gridBounds.maxX - gridBounds.minX) / gridSize, 0.0001f);
+	_sectorGridCellHeight = MAX((gridBounds.maxY - gridBounds.minY) / gridSize, 0.0001f);
+
+	// Filling the cells in the sector order keeps the lookups returning
+	// the same sector as a scan of the whole list.
+	_sectorGrid.resize(gridSize * gridSize);
+	uint nextUnbounded = 0;
+	for (int i = 0; i < _numSectors; i++) {
+		if (nextUnbounded < _unboundedSectors.size() && _unboundedSectors[nextUnbounded] == i) {
+			nextUnbounded++;
+			for (int j = 0; j < gridSize * gridSize; j++)
+				_sectorGrid[j].push_back(i);
+			continue;
+		}
+
+		const SectorBounds &bounds = queryBounds[i];
+		int x0 = CLIP<int>((bounds.minX - gridBounds.minX) / _sectorGridCellWidth, 0, gridSize - 1);
+		int y0 = CLIP<int>((bounds.minY - gridBounds.minY) / _sectorGridCellHeight, 0, gridSize - 1);
+		int x1 = CLIP<int>((bounds.maxX - gridBounds.minX) / _sectorGridCellWidth, 0, gridSize - 1);
+		int y1 = CLIP<int>((bounds.maxY - gridBounds.minY) / _sectorGridCellHeight, 0, gridSize - 1);
+		for (int y = y0; y <= y1; y++) {
+			for (int x = x0; x <= x1; x++)
+				_sectorGrid[y * gridSize + x].push_back(i);
+		}
+	}
+
+	_sectorGridValid = true;
+}
+
+const Common::Array<int> &Set::getSectorCandidates(const Math::Vector3d &p) {
+	if (!_sectorGridValid)
+		buildSectorGrid();
+
+	float x, y;
+	getGroundCoords(p, x, y);
+	if (x < _sectorGridBounds.minX || x > _sectorGridBounds.maxX ||
+			y < _sectorGridBounds.minY || y > _sectorGridBounds.maxY)
+		return _unboundedSectors;
+
+	int cellX = MIN<int>((x - _sectorGridBounds.minX) / _sectorGridCellWidth, kSectorGridSize - 1);
+	int cellY = MIN<int>((y - _sectorGridBounds.minY) / _sectorGridCellHeight, kSectorGridSize - 1);
+	return _sectorGrid[cellY * kSectorGridSize + cellX];
+}
+
+void Set::invalidateSectorCaches() {
+	_sectorLinksValid = false;
+	_sectorGridValid = false;
 }
 
 void Set::setLightIntensity(const char *light, float intensity) {
@@ -23,6 +23,8 @@
 #ifndef GRIM_SET_H
 #define GRIM_SET_H
 
+#include "common/array.h"
+
 #include "engines/grim/pool.h"
 #include "engines/grim/object.h"
 #include "engines/grim/color.h"
@@ -103,6 +105,20 @@ public:
 	void shrinkBoxes(float radius);
 	void unshrinkBoxes();
 
+	// A sector reachable from another one, and the edges leading to it
+	struct SectorLink {
+		int sector;
+		Common::Array<Math::Line3d> bridges;
+	};
+
+	/**
+	 * Returns the walkable sectors adjacent to the sector with the given
+	 * index, regardless of their visibility. The adjacency graph is built
+	 * on the first request after the set is loaded or the sectors are shrunk.
+	 */
+	const Common::Array<SectorLink> &getSectorLinks(int id);
+	int getSectorIndex(const Sector *sector) const;
+
 	void addObjectState(const ObjectState::Ptr &s);
 	void deleteObjectState(const ObjectState::Ptr &s) {
 		_states.remove(s);
@@ -159,6 +175,22 @@ private:
 	int _numSetups, _numLights, _numSectors, _numObjectStates, _numShadows;
 	bool _enableLights;
 	Sector **_sectors;
+	Common::Array<Common::Array<SectorLink> > _sectorLinks;
+	bool _sectorLinksValid;
+
+	static const int kSectorGridSize = 16;
+
+	// Uniform grid on the ground plane, each cell listing in order the
+	// sectors which may contain a point of the cell.
+	struct SectorBounds {
+		float minX, minY, maxX, maxY;
+	};
+	Common::Array<SectorBounds> _sectorBounds;
+	Common::Array<Common::Array<int> > _sectorGrid;
+	Common::Array<int> _unboundedSectors;
+	SectorBounds _sectorGridBounds;
+	float _sectorGridCellWidth, _sectorGridCellHeight;
+	bool _sectorGridValid;
 	Light *_lights;
 	Common::List<Light *> _lightsList;
 	Common::List<Light *> _overworldLightsList;
@@ -171,6 +203,11 @@ private:
 
 	Math::Frustum _frustum;
 
+	void buildSectorLinks();
+	void buildSectorGrid();
+	const Common::Array<int> &getSectorCandidates(const Math::Vector3d &p);
+	void invalidateSectorCaches();
+
 	friend class GrimEngine;
 };
 
@@ -26,6 +26,37 @@
 
 namespace Myst3 {
 
+ResourceKey::ResourceKey(const char *roomName, uint32 idx, uint16 f, DirectorySubEntry::ResourceType t) :
+		room(0), index(idx), face(f), type(t) {
+	for (uint i = 0; i < 4 && roomName[i]; i++)
+		room |= (byte)roomName[i] << (24 - 8 * i);
+}
+
+/**
+ * A read stream over a cached payload, keeping it alive
+ */
+class CachedDataStream : public Common::MemoryReadStream {
+public:
+	CachedDataStream(const Common::SharedPtr<byte> &data, uint32 size) :
+		Common::MemoryReadStream(data.get(), size, DisposeAfterUse::NO),
+		_data(data) {
+	}
+
+private:
+	Common::SharedPtr<byte> _data;
+};
+
+struct FreeDeleter {
+	void operator()(byte *ptr) { free(ptr); }
+};
+
+Archive::Archive() :
+		_multipleRoom(false),
+		_dataCacheUsed(0),
+		_dataCacheUseCounter(0) {
+	memset(_roomName, 0, sizeof(_roomName));
+}
+
 void Archive::_decryptHeader(Common::SeekableReadStream &inStream, Common::WriteStream &outStream) {
 	static const uint32 addKey = 0x3C6EF35F;
 	static const uint32 multKey = 0x0019660D;
@@ -70,6 +101,36 @@ void Archive::_readDirectory() {
 
 		_directory.push_back(entry);
 	}
+
+	_buildIndex();
+}
+
+void Archive::_buildIndex() {
+	_index.clear();
+
+	// Only the first entry for a room and index is ever looked at
+	ResourceIndex entries;
+	for (uint i = 0; i < _directory.size(); i++) {
+		DirectoryEntry &entry = _directory[i];
+		ResourceKey entryKey(entry.getRoom(), entry.getIndex(), 0, DirectorySubEntry::kCubeFace);
+		if (entries.contains(entryKey))
+			continue;
+		entries[entryKey] = 0;
+
+		for (uint j = 0; j < entry.getSubEntryCount(); j++) {
+			const DirectorySubEntry *subEntry = entry.getSubEntry(j);
+			ResourceKey key(entry.getRoom(), entry.getIndex(), subEntry->getFace(), subEntry->getType());
+			if (!_index.contains(key))
+				_index[key] = subEntry;
+		}
+	}
+}
+
+void Archive::addToIndex(ResourceIndex &index) const {
+	for (ResourceIndex::const_iterator it = _index.begin(); it != _index.end(); ++it) {
+		if (!index.contains(it->_key))
+			index[it->_key] = it->_value;
+	}
 }
 
 void Archive::dumpToFiles() {
@@ -83,15 +144,52 @@ Common::MemoryReadStream *Archive::dumpToMemory(uint32 offset, uint32 size) {
 	return static_cast<Common::MemoryReadStream *>(_file.readStream(size));
 }
 
-const DirectorySubEntry *Archive::getDescription(const char *room, uint32 index, uint16 face, DirectorySubEntry::ResourceType type) {
-	for (uint i = 0; i < _directory.size(); i++) {
-		if (_directory[i].getIndex() == index
-				&& !strcmp(_directory[i].getRoom(), room)) {
-			return _directory[i].getItemDescription(face, type);
+Common::MemoryReadStream *Archive::getData(uint32 offset, uint32 size) {
+	DataCache::iterator it = _dataCache.find(offset);
+	if (it != _dataCache.end()) {
+		if (it->_value.size == size) {
+			it->_value.lastUse = ++_dataCacheUseCounter;
+			return new CachedDataStream(it->_value.data, size);
 		}
+
+		_dataCacheUsed -= it->_value.size;
+		_dataCache.erase(it);
 	}
 
-	return 0;
+	if (size > kMaxCachedDataSize)
+		return dumpToMemory(offset, size);
+
+	// Make room by evicting the least recently used payloads
+	while (_dataCacheUsed + size > kDataCacheSize && !_dataCache.empty()) {
+		DataCache::iterator oldest = _dataCache.begin();
+		for (DataCache::iterator i = _dataCache.begin(); i != _dataCache.end(); ++i) {
+			if (i->_value.lastUse < oldest->_value.lastUse)
+				oldest = i;
+		}
+
+		_dataCacheUsed -= oldest->_value.size;
+		_dataCache.erase(oldest);
+	}
+
+	byte *buffer = (byte *)malloc(size);
+	_file.seek(offset);
+	_file.read(buffer, size);
+
+	CachedData &cached = _dataCache[offset];
+	cached.data = Common::SharedPtr<byte>(buffer, FreeDeleter());
+	cached.size = size;
+	cached.lastUse = ++_dataCacheUseCounter;
+	_dataCacheUsed += size;
+
+	return new CachedDataStream(cached.data, size);
+}
+
+const DirectorySubEntry *Archive::getDescription(const char *room, uint32 index, uint16 face, DirectorySubEntry::ResourceType type) {
+	ResourceIndex::const_iterator it = _index.find(ResourceKey(room, index, face, type));
+	if (it == _index.end())
+		return 0;
+
+	return it->_value;
 }
 
 bool Archive::open(const char *fileName, const char *room) {
@@ -112,6 +210,9 @@ bool Archive::open(const char *fileName, const char *room) {
 
 void Archive::close() {
 	_directory.clear();
+	_index.clear();
+	_dataCache.clear();
+	_dataCacheUsed = 0;
 	_file.close();
 }
 
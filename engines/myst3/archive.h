@@ -27,24 +27,82 @@
 #include "common/stream.h"
 #include "common/array.h"
 #include "common/file.h"
+#include "common/hashmap.h"
+#include "common/ptr.h"
 
 namespace Myst3 {
 
+/**
+ * Identifies a resource across all the archives
+ */
+struct ResourceKey {
+	uint32 room;
+	uint32 index;
+	uint16 face;
+	uint16 type;
+
+	ResourceKey(const char *roomName, uint32 idx, uint16 f, DirectorySubEntry::ResourceType t);
+
+	bool operator==(const ResourceKey &other) const {
+		return room == other.room && index == other.index && face == other.face && type == other.type;
+	}
+};
+
+struct ResourceKeyHash {
+	uint operator()(const ResourceKey &key) const {
+		return key.room ^ (key.index * 31) ^ (key.face << 24) ^ (key.type << 16);
+	}
+};
+
+typedef Common::HashMap<ResourceKey, const DirectorySubEntry *, ResourceKeyHash> ResourceIndex;
+
 class Archive {
 private:
 	bool _multipleRoom;
 	char _roomName[5];
 	Common::File _file;
 	Common::Array<DirectoryEntry> _directory;
+	ResourceIndex _index;
+
+	// Payloads kept in memory, so resources fetched again are not read again
+	struct CachedData {
+		Common::SharedPtr<byte> data;
+		uint32 size;
+		uint32 lastUse;
+	};
+
+	typedef Common::HashMap<uint32, CachedData> DataCache;
+
+	// Larger payloads are movies, read once per playback
+	static const uint32 kMaxCachedDataSize = 512 * 1024;
+	static const uint32 kDataCacheSize = 4 * 1024 * 1024;
+
+	DataCache _dataCache;
+	uint32 _dataCacheUsed;
+	uint32 _dataCacheUseCounter;
 
 	void _decryptHeader(Common::SeekableReadStream &inStream, Common::WriteStream &outStream);
 	void _readDirectory();
+	void _buildIndex();
 public:
 
 	const DirectorySubEntry *getDescription(const char *room, uint32 index, uint16 face, DirectorySubEntry::ResourceType type);
+
+	/** Add the resources of this archive not already found in index */
+	void addToIndex(ResourceIndex &index) const;
 	Common::MemoryReadStream *dumpToMemory(uint32 offset, uint32 size);
+
+	/**
+	 * Get a read only stream for a payload of the archive.
+	 *
+	 * Small payloads are cached, the returned stream then shares the cached
+	 * buffer. It stays valid when the payload is evicted or the archive closed.
+	 */
+	Common::MemoryReadStream *getData(uint32 offset, uint32 size);
 	void dumpToFiles();
 
+	Archive();
+
 	bool open(const char *fileName, const char *room);
 	void close();
 };
@@ -42,6 +42,8 @@ Console::Console(Myst3Engine *vm) : GUI::Debugger(), _vm(vm) {
 	registerCmd("fillInventory",			WRAP_METHOD(Console, Cmd_FillInventory));
 	registerCmd("dumpArchive",			WRAP_METHOD(Console, Cmd_DumpArchive));
 	registerCmd("dumpMasks",			WRAP_METHOD(Console, Cmd_DumpMasks));
+	registerCmd("resourceStats",			WRAP_METHOD(Console, Cmd_ResourceStats));
+	registerCmd("opcodeStats",			WRAP_METHOD(Console, Cmd_OpcodeStats));
 }
 
 Console::~Console() {
@@ -380,6 +382,56 @@ bool Console::Cmd_DumpMasks(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::Cmd_ResourceStats(int argc, const char **argv) {
+	const Myst3Engine::ResourceLookupStats &stats = _vm->_resourceStats;
+
+	debugPrintf("Indexed resources: %d\n", _vm->_resourceIndex.size());
+	debugPrintf("Lookups: %d\n", stats.lookups);
+	debugPrintf("Found in the common archives: %d\n", stats.commonHits);
+	debugPrintf("Found in the node archive: %d\n", stats.nodeHits);
+	debugPrintf("Not found: %d\n", stats.misses);
+
+	return true;
+}
+
+bool Console::Cmd_OpcodeStats(int argc, const char **argv) {
+	Script *script = _vm->_scriptEngine;
+
+	if (argc == 2) {
+		Common::String cmd = argv[1];
+		if (cmd == "on") {
+			script->setProfiling(true);
+		} else if (cmd == "off") {
+			script->setProfiling(false);
+		} else if (cmd == "reset") {
+			script->resetOpcodeStats();
+		} else {
+			argc = 0;
+		}
+	}
+
+	if (argc > 2 || argc == 0) {
+		debugPrintf("Count and time the script opcodes run.\n");
+		debugPrintf("Usage :\n");
+		debugPrintf("opcodeStats [on|off|reset]\n");
+		return true;
+	}
+
+	debugPrintf("Profiling is %s\n", script->isProfiling() ? "on" : "off");
+
+	if (argc == 1) {
+		for (uint i = 0; i < 256; i++) {
+			const Script::OpcodeStats &stats = script->getOpcodeStats(i);
+			if (stats.count == 0)
+				continue;
+
+			debugPrintf("%3d %-32s %8d runs %6d ms\n", i, script->getOpcodeName(i), stats.count, stats.time);
+		}
+	}
+
+	return true;
+}
+
 bool Console::dumpFaceMask(uint16 index, int face, DirectorySubEntry::ResourceType type) {
 	const DirectorySubEntry *maskDesc = _vm->getFileDescription(0, index, face, type);
 
@@ -56,6 +56,8 @@ private:
 	bool Cmd_Extract(int argc, const char **argv);
 	bool Cmd_DumpArchive(int argc, const char **argv);
 	bool Cmd_DumpMasks(int argc, const char **argv);
+	bool Cmd_ResourceStats(int argc, const char **argv);
+	bool Cmd_OpcodeStats(int argc, const char **argv);
 	bool Cmd_FillInventory(int argc, const char **argv);
 };
 
@@ -28,7 +28,9 @@
 #include "common/hashmap.h"
 #include "common/md5.h"
 #include "common/memstream.h"
+#include "common/savefile.h"
 #include "common/substream.h"
+#include "common/system.h"
 #include "common/winexe_pe.h"
 
 namespace Myst3 {
@@ -37,7 +39,10 @@ Database::Database(Myst3Engine *vm) :
 		_vm(vm),
 		_currentRoomID(0),
 		_executableVersion(0),
-		_currentRoomData(0) {
+		_currentRoomData(0),
+		_data(0),
+		_dataSize(0),
+		_dataBigEndian(false) {
 
 	_executableVersion = _vm->getExecutableVersion();
 
@@ -47,6 +52,8 @@ Database::Database(Myst3Engine *vm) :
 		error("Could not find any executable to load");
 	}
 
+	loadDatabaseData();
+
 	// Load the ages and rooms description
 	Common::SeekableSubReadStreamEndian *file = openDatabaseFile();
 	file->seek(_executableVersion->ageTableOffset);
@@ -91,6 +98,10 @@ Database::Database(Myst3Engine *vm) :
 	delete file;
 }
 
+Database::~Database() {
+	free(_data);
+}
+
 void Database::preloadCommonRooms(Common::SeekableSubReadStreamEndian *file) {
 	// XXXX, MENU, JRNL
 	static const uint32 commonRooms[3] = { 101, 901, 902 };
@@ -603,18 +614,48 @@ uint32 Database::getAgeLabelId(uint32 ageID) {
 	return 0;
 }
 
-Common::SeekableSubReadStreamEndian *Database::openDatabaseFile() const {
+static const uint32 kDatabaseCacheVersion = 1;
+
+/**
+ * Each executable gets its own cache, so that several versions of the game
+ * can share a save directory.
+ */
+static Common::String getDatabaseCacheFileName(const uint8 executableMD5[16]) {
+	return Common::String::format("myst3-%02x%02x%02x%02x.dbcache",
+			executableMD5[0], executableMD5[1], executableMD5[2], executableMD5[3]);
+}
+
+void Database::loadDatabaseData() {
 	assert(_executableVersion);
 
 	Common::SeekableReadStream *stream = SearchMan.createReadStreamForMember(_executableVersion->executable);
-	bool bigEndian = false;
+	if (!stream)
+		error("Unable to open the executable %s", _executableVersion->executable);
+
+	bool extract = _vm->getPlatform() == Common::kPlatformMacintosh
+			|| _vm->getDefaultLanguage() == Common::RU_RUS
+			|| _executableVersion->safeDiskKey;
+
+	// Extracting the data from the executable takes a while, its result is
+	// cached in the save directory. The cache is only valid for the exact
+	// same executable.
+	uint8 executableMD5[16];
+	if (extract) {
+		Common::computeStreamMD5(*stream, executableMD5);
+		stream->seek(0);
+
+		if (readDatabaseCache(executableMD5)) {
+			delete stream;
+			return;
+		}
+	}
 
 	if (_vm->getPlatform() == Common::kPlatformMacintosh) {
 		// The data we need is always in segment 1
 		Common::SeekableReadStream *segment = decompressPEFDataSegment(stream, 1);
 		delete stream;
 		stream = segment;
-		bigEndian = true;
+		_dataBigEndian = true;
 	} else if (_vm->getDefaultLanguage() == Common::RU_RUS) {
 		stream = extractRussianM3R(stream);
 	} else if (_executableVersion->safeDiskKey) {
@@ -638,7 +679,100 @@ Common::SeekableSubReadStreamEndian *Database::openDatabaseFile() const {
 #endif // USE_SAFEDISC
 	}
 
-	return new Common::SeekableSubReadStreamEndian(stream, 0, stream->size(), bigEndian, DisposeAfterUse::YES);
+	_dataSize = stream->size();
+	_data = (byte *)malloc(_dataSize);
+	if (!_data)
+		error("Unable to allocate %u bytes for the database", _dataSize);
+	stream->seek(0);
+	stream->read(_data, _dataSize);
+	delete stream;
+
+	if (extract)
+		writeDatabaseCache(executableMD5);
+}
+
+bool Database::readDatabaseCache(const uint8 executableMD5[16]) {
+	Common::String fileName = getDatabaseCacheFileName(executableMD5);
+	Common::InSaveFile *cache = _vm->getSaveFileManager()->openForLoading(fileName);
+	if (!cache)
+		return false;
+
+	uint8 md5[16];
+	bool valid = cache->readUint32BE() == MKTAG('M', '3', 'D', 'B')
+			&& cache->readUint32BE() == kDatabaseCacheVersion
+			&& cache->read(md5, sizeof(md5)) == sizeof(md5)
+			&& !memcmp(md5, executableMD5, sizeof(md5));
+
+	if (valid) {
+		bool bigEndian = cache->readByte() != 0;
+		uint32 size = cache->readUint32BE();
+		cache->read(md5, sizeof(md5));
+
+		// The size comes from the file, do not trust it
+		byte *data = 0;
+		int32 remaining = cache->size() - cache->pos();
+		valid = !cache->err() && remaining >= 0 && size <= (uint32)remaining;
+		if (valid) {
+			data = (byte *)malloc(size);
+			valid = data && cache->read(data, size) == size;
+		}
+
+		// Check the data was not truncated or damaged
+		uint8 dataMD5[16];
+		if (valid) {
+			Common::MemoryReadStream dataStream(data, size);
+			Common::computeStreamMD5(dataStream, dataMD5);
+			valid = !memcmp(md5, dataMD5, sizeof(md5));
+		}
+
+		if (valid) {
+			_data = data;
+			_dataSize = size;
+			_dataBigEndian = bigEndian;
+		} else {
+			free(data);
+		}
+	}
+
+	delete cache;
+
+	// A damaged or outdated cache is silently replaced
+	if (!valid)
+		debug("Rebuilding the database cache %s", fileName.c_str());
+
+	return valid;
+}
+
+void Database::writeDatabaseCache(const uint8 executableMD5[16]) {
+	Common::String fileName = getDatabaseCacheFileName(executableMD5);
+	Common::OutSaveFile *cache = _vm->getSaveFileManager()->openForSaving(fileName, false);
+	if (!cache)
+		return;
+
+	uint8 dataMD5[16];
+	Common::MemoryReadStream dataStream(_data, _dataSize);
+	Common::computeStreamMD5(dataStream, dataMD5);
+
+	cache->writeUint32BE(MKTAG('M', '3', 'D', 'B'));
+	cache->writeUint32BE(kDatabaseCacheVersion);
+	cache->write(executableMD5, 16);
+	cache->writeByte(_dataBigEndian);
+	cache->writeUint32BE(_dataSize);
+	cache->write(dataMD5, sizeof(dataMD5));
+	cache->write(_data, _dataSize);
+	cache->finalize();
+
+	if (cache->err())
+		warning("Unable to write the database cache %s", fileName.c_str());
+
+	delete cache;
+}
+
+Common::SeekableSubReadStreamEndian *Database::openDatabaseFile() const {
+	assert(_data);
+
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(_data, _dataSize);
+	return new Common::SeekableSubReadStreamEndian(stream, 0, _dataSize, _dataBigEndian, DisposeAfterUse::YES);
 }
 
 static uint32 getPEFArgument(Common::SeekableReadStream *stream, uint &pos) {
@@ -87,6 +87,7 @@ public:
 	 * Initialize the database from an executable file
 	 */
 	Database(Myst3Engine *vm);
+	~Database();
 
 	/**
 	 * Loads a room's nodes into the database
@@ -141,6 +142,11 @@ private:
 	Myst3Engine *_vm;
 	const ExecutableVersion *_executableVersion;
 
+	// The data part of the executable, decrypted or decompressed once
+	byte *_data;
+	uint32 _dataSize;
+	bool _dataBigEndian;
+
 	Common::Array<AgeData> _ages;
 
 	uint32 _currentRoomID;
@@ -175,6 +181,9 @@ private:
 	void loadSoundNames(Common::ReadStreamEndian *s);
 	void loadAmbientCues(Common::ReadStreamEndian *s);
 
+	void loadDatabaseData();
+	bool readDatabaseCache(const uint8 executableMD5[16]);
+	void writeDatabaseCache(const uint8 executableMD5[16]);
 	Common::SeekableSubReadStreamEndian *openDatabaseFile() const;
 	Common::SeekableReadStream *decompressPEFDataSegment(Common::SeekableReadStream *stream, uint segmentID) const;
 	Common::SeekableReadStream *extractRussianM3R(Common::SeekableReadStream *stream) const;
@@ -44,8 +44,10 @@ public:
 	void readFromStream(Common::SeekableReadStream &inStream, const char *room);
 	void dumpToFiles(Common::SeekableReadStream &inStream);
 	DirectorySubEntry *getItemDescription(uint16 face, DirectorySubEntry::ResourceType type);
-	uint32 getIndex() { return _index; }
-	const char *getRoom() { return _roomName; }
+	uint32 getIndex() const { return _index; }
+	const char *getRoom() const { return _roomName; }
+	uint getSubEntryCount() const { return _subentries.size(); }
+	const DirectorySubEntry *getSubEntry(uint i) const { return &_subentries[i]; }
 };
 
 } // End of namespace Myst3
@@ -125,7 +125,7 @@ void DirectorySubEntry::dumpToFile(Common::SeekableReadStream &inStream, const c
 }
 
 Common::MemoryReadStream *DirectorySubEntry::getData() const {
-	return _archive->dumpToMemory(_offset, _size);
+	return _archive->getData(_offset, _size);
 }
 
 uint32 DirectorySubEntry::getMiscData(uint index) const {
@@ -25,8 +25,31 @@
 #include "engines/myst3/state.h"
 #include "engines/myst3/sound.h"
 
+#include "common/endian.h"
+
 namespace Myst3 {
 
+/**
+ * Returns the position of the first non zero mask value of a row
+ * at or after x, testing four mask values at a time
+ */
+static inline uint nextMasked(const byte *maskRow, uint x, uint width) {
+	while (x + 4 <= width && READ_UINT32(maskRow + x) == 0)
+		x += 4;
+
+	while (x < width && maskRow[x] == 0)
+		x++;
+
+	return x;
+}
+
+/**
+ * Blends two opaque pixels half and half
+ */
+static inline uint32 blendHalf(uint32 color1, uint32 color2) {
+	return 0xFF000000 | ((0x007F7F7F & (color1 >> 1)) + (0x007F7F7F & (color2 >> 1)));
+}
+
 Effect::Effect(Myst3Engine *vm) :
 		_vm(vm) {
 }
@@ -220,54 +243,53 @@ void WaterEffect::apply(Graphics::Surface *src, Graphics::Surface *dst, Graphics
 		vDisplacement = _verticalDisplacement;
 	}
 
-	uint32 *dstPtr = (uint32 *)dst->getPixels();
-	byte *maskPtr = (byte *)mask->getPixels();
+	int32 amplOffset = _vm->_state->getWaterEffectAmplOffset();
+	int32 attenuation = _vm->_state->getWaterEffectAttenuation();
+	int32 srcPitch = src->pitch / 4;
 
 	for (uint y = 0; y < dst->h; y++) {
 		if (!bottomFace) {
-			uint32 strength = (320 * (9 - y / 64)) / _vm->_state->getWaterEffectAttenuation();
+			uint32 strength = (320 * (9 - y / 64)) / attenuation;
 			if (strength > 4)
 				strength = 4;
 			hDisplacement = _horizontalDisplacements[strength];
 		}
 
-		for (uint x = 0; x < dst->w; x++) {
-			int8 maskValue = *maskPtr;
-
-			if (maskValue != 0) {
-				int8 xOffset = hDisplacement[x];
-				int8 yOffset = vDisplacement[y];
+		const byte *maskRow = (const byte *)mask->getBasePtr(0, y);
+		const uint32 *srcRow = (const uint32 *)src->getBasePtr(0, y);
+		uint32 *dstRow = (uint32 *)dst->getBasePtr(0, y);
 
-				if (maskValue < 8) {
-					maskValue -= _vm->_state->getWaterEffectAmplOffset();
-					if (maskValue < 0) {
-						maskValue = 0;
-					}
+		for (uint x = nextMasked(maskRow, 0, dst->w); x < dst->w; x = nextMasked(maskRow, x + 1, dst->w)) {
+			int8 maskValue = maskRow[x];
+			int8 xOffset = hDisplacement[x];
+			int8 yOffset = vDisplacement[y];
 
-					if (xOffset >= 0) {
-						if (xOffset > maskValue)
-							xOffset = maskValue;
-					} else {
-						if (-xOffset > maskValue)
-							xOffset = -maskValue;
-					}
-					if (yOffset >= 0) {
-						if (yOffset > maskValue)
-							yOffset = maskValue;
-					} else {
-						if (-yOffset > maskValue)
-							yOffset = -maskValue;
-					}
+			if (maskValue < 8) {
+				maskValue -= amplOffset;
+				if (maskValue < 0) {
+					maskValue = 0;
 				}
 
-				uint32 srcValue1 = *(uint32 *) src->getBasePtr(x + xOffset, y + yOffset);
-				uint32 srcValue2 = *(uint32 *) src->getBasePtr(x, y);
-
-				*dstPtr = 0xFF000000 | ((0x007F7F7F & (srcValue1 >> 1)) + (0x007F7F7F & (srcValue2 >> 1)));
+				if (xOffset >= 0) {
+					if (xOffset > maskValue)
+						xOffset = maskValue;
+				} else {
+					if (-xOffset > maskValue)
+						xOffset = -maskValue;
+				}
+				if (yOffset >= 0) {
+					if (yOffset > maskValue)
+						yOffset = maskValue;
+				} else {
+					if (-yOffset > maskValue)
+						yOffset = -maskValue;
+				}
 			}
 
-			maskPtr++;
-			dstPtr++;
+			uint32 srcValue1 = srcRow[(int32)x + xOffset + yOffset * srcPitch];
+			uint32 srcValue2 = srcRow[x];
+
+			dstRow[x] = blendHalf(srcValue1, srcValue2);
 		}
 	}
 }
@@ -330,37 +352,38 @@ void LavaEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Surfa
 	if (!mask)
 		error("No mask for face %d", face);
 
-	uint32 *dstPtr = (uint32 *)dst->getPixels();
-	byte *maskPtr = (byte *)mask->getPixels();
-
-	for (uint y = 0; y < dst->h; y++) {
-		for (uint x = 0; x < dst->w; x++) {
-			uint8 maskValue = *maskPtr;
+	// The vertical offset only depends on the mask value
+	int32 yOffsets[256];
+	for (uint i = 0; i < 256; i++) {
+		int32 maxOffset = (i >> 6) & 0x3;
+		yOffsets[i] = MIN(_displacement[i], maxOffset);
+	}
 
-			if (maskValue != 0) {
-				int32 xOffset= _displacement[(maskValue + y) % 256];
-				int32 yOffset = _displacement[maskValue % 256];
-				int32 maxOffset = (maskValue >> 6) & 0x3;
+	int32 srcPitch = src->pitch / 4;
 
-				if (yOffset > maxOffset) {
-					yOffset = maxOffset;
-				}
-				if (xOffset > maxOffset) {
-					xOffset = maxOffset;
-				}
+	for (uint y = 0; y < dst->h; y++) {
+		const byte *maskRow = (const byte *)mask->getBasePtr(0, y);
+		const uint32 *srcRow = (const uint32 *)src->getBasePtr(0, y);
+		uint32 *dstRow = (uint32 *)dst->getBasePtr(0, y);
+
+		for (uint x = nextMasked(maskRow, 0, dst->w); x < dst->w; x = nextMasked(maskRow, x + 1, dst->w)) {
+			uint8 maskValue = maskRow[x];
+			int32 xOffset = _displacement[(maskValue + y) % 256];
+			int32 yOffset = yOffsets[maskValue];
+			int32 maxOffset = (maskValue >> 6) & 0x3;
+
+			if (xOffset > maxOffset) {
+				xOffset = maxOffset;
+			}
 
-//				uint32 srcValue1 = *(uint32 *)src->getBasePtr(x + xOffset, y + yOffset);
-//				uint32 srcValue2 = *(uint32 *)src->getBasePtr(x, y);
+//			uint32 srcValue1 = srcRow[(int32)x + xOffset + yOffset * srcPitch];
+//			uint32 srcValue2 = srcRow[x];
 //
-//				*dstPtr = 0xFF000000 | ((0x007F7F7F & (srcValue1 >> 1)) + (0x007F7F7F & (srcValue2 >> 1)));
-
-				// TODO: The original does "blending" as above, but strangely
-				// this looks more like the original rendering
-				*dstPtr = *(uint32 *)src->getBasePtr(x + xOffset, y + yOffset);
-			}
+//			dstRow[x] = blendHalf(srcValue1, srcValue2);
 
-			maskPtr++;
-			dstPtr++;
+			// TODO: The original does "blending" as above, but strangely
+			// this looks more like the original rendering
+			dstRow[x] = srcRow[(int32)x + xOffset + yOffset * srcPitch];
 		}
 	}
 }
@@ -465,24 +488,26 @@ void MagnetEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Sur
 }
 
 void MagnetEffect::apply(Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask, int32 position) {
-	uint32 *dstPtr = (uint32 *)dst->getPixels();
-	byte *maskPtr = (byte *)mask->getPixels();
+	// The displacement only depends on the mask value
+	int32 displacements[256];
+	for (uint i = 0; i < 256; i++) {
+		displacements[i] = _verticalDisplacement[((int32)i + position) % 256];
+	}
 
-	for (uint y = 0; y < dst->h; y++) {
-		for (uint x = 0; x < dst->w; x++) {
-			uint8 maskValue = *maskPtr;
+	int32 srcPitch = src->pitch / 4;
 
-			if (maskValue != 0) {
-				uint32 displacement = _verticalDisplacement[(maskValue + position) % 256];
+	for (uint y = 0; y < dst->h; y++) {
+		const byte *maskRow = (const byte *)mask->getBasePtr(0, y);
+		const uint32 *srcRow = (const uint32 *)src->getBasePtr(0, y);
+		uint32 *dstRow = (uint32 *)dst->getBasePtr(0, y);
 
-				uint32 srcValue1 = *(uint32 *) src->getBasePtr(x, y + displacement);
-				uint32 srcValue2 = *(uint32 *) src->getBasePtr(x, y);
+		for (uint x = nextMasked(maskRow, 0, dst->w); x < dst->w; x = nextMasked(maskRow, x + 1, dst->w)) {
+			int32 displacement = displacements[maskRow[x]];
 
-				*dstPtr = 0xFF000000 | ((0x007F7F7F & (srcValue1 >> 1)) + (0x007F7F7F & (srcValue2 >> 1)));
-			}
+			uint32 srcValue1 = srcRow[(int32)x + displacement * srcPitch];
+			uint32 srcValue2 = srcRow[x];
 
-			maskPtr++;
-			dstPtr++;
+			dstRow[x] = blendHalf(srcValue1, srcValue2);
 		}
 	}
 }
@@ -24,6 +24,7 @@ MODULE_OBJS := \
 	node.o \
 	nodecube.o \
 	nodeframe.o \
+	prefetcher.o \
 	puzzles.o \
 	scene.o \
 	script.o \
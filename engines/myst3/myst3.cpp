@@ -48,6 +48,7 @@
 #include "engines/myst3/sound.h"
 #include "engines/myst3/ambient.h"
 #include "engines/myst3/transition.h"
+#include "engines/myst3/prefetcher.h"
 
 #include "image/jpeg.h"
 
@@ -72,7 +73,7 @@ Myst3Engine::Myst3Engine(OSystem *syst, const Myst3GameDescription *version) :
 		_db(0), _console(0), _scriptEngine(0),
 		_state(0), _node(0), _scene(0), _archiveNode(0),
 		_cursor(0), _inventory(0), _gfx(0), _menu(0),
-		_rnd(0), _sound(0), _ambient(0),
+		_rnd(0), _sound(0), _ambient(0), _prefetcher(0),
 		_inputSpacePressed(false), _inputEnterPressed(false),
 		_inputEscapePressed(false), _inputTildePressed(false),
 		_menuAction(0), _projectorBackground(0),
@@ -131,6 +132,7 @@ Myst3Engine::~Myst3Engine() {
 	delete _rnd;
 	delete _sound;
 	delete _ambient;
+	delete _prefetcher;
 	delete _gfx;
 }
 
@@ -173,6 +175,7 @@ Common::Error Myst3Engine::run() {
 	_scene = new Scene(this);
 	_menu = new Menu(this);
 	_archiveNode = new Archive();
+	_prefetcher = new Prefetcher(this);
 
 	_system->showMouse(false);
 
@@ -208,10 +211,13 @@ Common::Error Myst3Engine::run() {
 		}
 
 		drawFrame();
+
+		_prefetcher->update();
 	}
 
 	unloadNode();
 
+	_prefetcher->clear();
 	_archiveNode->close();
 	_gfx->freeFont();
 
@@ -313,9 +319,14 @@ void Myst3Engine::openArchives() {
 			addArchive(menuLanguage + ".m3u", true);
 
 	addArchive("RSRC.m3r", true);
+
+	for (uint i = 0; i < _archivesCommon.size(); i++)
+		_archivesCommon[i]->addToIndex(_resourceIndex);
 }
 
 void Myst3Engine::closeArchives() {
+	_resourceIndex.clear();
+
 	for (uint i = 0; i < _archivesCommon.size(); i++)
 		delete _archivesCommon[i];
 
@@ -685,6 +696,8 @@ void Myst3Engine::loadNode(uint16 nodeID, uint32 roomID, uint32 ageID) {
 		_db->setCurrentRoom(roomID);
 		Common::String nodeFile = Common::String::format("%snodes.m3a", newRoomName);
 
+		// The prefetched faces reference the node archive being closed
+		_prefetcher->clear();
 		_archiveNode->close();
 		if (!_archiveNode->open(nodeFile.c_str(), newRoomName)) {
 			error("Unable to open archive %s", nodeFile.c_str());
@@ -702,6 +715,8 @@ void Myst3Engine::loadNode(uint16 nodeID, uint32 roomID, uint32 ageID) {
 	// Releeshan to the player when he is trapped between both shields.
 	if (nodeID == 9 && roomID == 801)
 		_state->setVar(39, 0);
+
+	_prefetcher->predictNextNodes();
 }
 
 void Myst3Engine::unloadNode() {
@@ -1135,19 +1150,25 @@ const DirectorySubEntry *Myst3Engine::getFileDescription(const char* room, uint3
 		room = currentRoom;
 	}
 
-	const DirectorySubEntry *desc = 0;
+	_resourceStats.lookups++;
 
 	// Search common archives
-	uint i = 0;
-	while (!desc && i < _archivesCommon.size()) {
-		desc = _archivesCommon[i]->getDescription(room, index, face, type);
-		i++;
+	ResourceIndex::const_iterator it = _resourceIndex.find(ResourceKey(room, index, face, type));
+	if (it != _resourceIndex.end()) {
+		_resourceStats.commonHits++;
+		return it->_value;
 	}
 
 	// Search currently loaded node archive
-	if (!desc && _archiveNode)
+	const DirectorySubEntry *desc = 0;
+	if (_archiveNode)
 		desc = _archiveNode->getDescription(room, index, face, type);
 
+	if (desc)
+		_resourceStats.nodeHits++;
+	else
+		_resourceStats.misses++;
+
 	return desc;
 }
 
@@ -89,6 +89,7 @@ class Ambient;
 class ShakeEffect;
 class RotationEffect;
 class Transition;
+class Prefetcher;
 struct NodeData;
 struct Myst3GameDescription;
 
@@ -111,6 +112,7 @@ public:
 	Database *_db;
 	Sound *_sound;
 	Ambient *_ambient;
+	Prefetcher *_prefetcher;
 	
 	Common::RandomSource *_rnd;
 
@@ -194,6 +196,19 @@ private:
 	Common::Array<Archive *> _archivesCommon;
 	Archive *_archiveNode;
 
+	// Resources of all the common archives, the first archive providing one wins
+	ResourceIndex _resourceIndex;
+
+	struct ResourceLookupStats {
+		uint32 lookups;
+		uint32 commonHits;
+		uint32 nodeHits;
+		uint32 misses;
+
+		ResourceLookupStats() : lookups(0), commonHits(0), nodeHits(0), misses(0) {}
+	};
+	ResourceLookupStats _resourceStats;
+
 	Script *_scriptEngine;
 
 	Common::Array<ScriptedMovie *> _movies;
@@ -23,6 +23,7 @@
 #include "engines/myst3/effects.h"
 #include "engines/myst3/node.h"
 #include "engines/myst3/myst3.h"
+#include "engines/myst3/prefetcher.h"
 #include "engines/myst3/state.h"
 #include "engines/myst3/subtitles.h"
 
@@ -32,7 +33,9 @@
 namespace Myst3 {
 
 void Face::setTextureFromJPEG(const DirectorySubEntry *jpegDesc) {
-	_bitmap = Myst3Engine::decodeJpeg(jpegDesc);
+	_bitmap = _vm->_prefetcher->takeFace(jpegDesc);
+	if (!_bitmap)
+		_bitmap = Myst3Engine::decodeJpeg(jpegDesc);
 	_texture = _vm->_gfx->createTexture(_bitmap);
 }
 
@@ -0,0 +1,149 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "engines/myst3/prefetcher.h"
+#include "engines/myst3/database.h"
+#include "engines/myst3/directorysubentry.h"
+#include "engines/myst3/myst3.h"
+#include "engines/myst3/state.h"
+
+#include "common/debug.h"
+
+#include "graphics/surface.h"
+
+namespace Myst3 {
+
+// Script opcodes moving to another node of the current room
+enum {
+	kOpGoToNodeTransition = 136,
+	kOpGoToNodeTrans2 = 137,
+	kOpGoToNodeTrans1 = 138
+};
+
+Prefetcher::Prefetcher(Myst3Engine *vm) :
+		_vm(vm) {
+}
+
+Prefetcher::~Prefetcher() {
+	clear();
+}
+
+void Prefetcher::freeFace(PrefetchedFace &face) {
+	if (face.bitmap) {
+		face.bitmap->free();
+		delete face.bitmap;
+		face.bitmap = nullptr;
+	}
+}
+
+int Prefetcher::findFace(const DirectorySubEntry *jpegDesc) const {
+	for (uint i = 0; i < _faces.size(); i++) {
+		if (_faces[i].desc == jpegDesc)
+			return i;
+	}
+
+	return -1;
+}
+
+void Prefetcher::clear() {
+	for (uint i = 0; i < _faces.size(); i++)
+		freeFace(_faces[i]);
+
+	_faces.clear();
+}
+
+void Prefetcher::predictNextNodes() {
+	uint16 currentNode = _vm->_state->getLocationNode();
+	NodePtr nodeData = _vm->_db->getNodeData(currentNode, _vm->_state->getLocationRoom());
+	if (!nodeData)
+		return;
+
+	Common::Array<PrefetchedFace> faces;
+	for (uint i = 0; i < nodeData->hotspots.size(); i++) {
+		const Common::Array<Opcode> &script = nodeData->hotspots[i].script;
+		for (uint j = 0; j < script.size(); j++) {
+			const Opcode &op = script[j];
+			if (op.op != kOpGoToNodeTransition && op.op != kOpGoToNodeTrans2 && op.op != kOpGoToNodeTrans1)
+				continue;
+
+			if (op.args.empty())
+				continue;
+
+			uint16 node = _vm->_state->valueOrVarValue(op.args[0]);
+			if (node == currentNode)
+				continue;
+
+			for (uint face = 1; face <= 6 && faces.size() < kMaxFaces; face++) {
+				const DirectorySubEntry *desc = _vm->getFileDescription(0, node, face, DirectorySubEntry::kCubeFace);
+				if (!desc)
+					break;
+
+				bool alreadyQueued = false;
+				for (uint k = 0; k < faces.size(); k++)
+					alreadyQueued |= faces[k].desc == desc;
+
+				if (alreadyQueued)
+					continue;
+
+				// Keep the faces that have already been decoded
+				PrefetchedFace prefetched;
+				prefetched.desc = desc;
+				prefetched.bitmap = nullptr;
+
+				int existing = findFace(desc);
+				if (existing >= 0) {
+					prefetched.bitmap = _faces[existing].bitmap;
+					_faces[existing].bitmap = nullptr;
+				}
+
+				faces.push_back(prefetched);
+			}
+		}
+	}
+
+	clear();
+	_faces = faces;
+}
+
+void Prefetcher::update() {
+	for (uint i = 0; i < _faces.size(); i++) {
+		if (!_faces[i].bitmap) {
+			_faces[i].bitmap = Myst3Engine::decodeJpeg(_faces[i].desc);
+			return;
+		}
+	}
+}
+
+Graphics::Surface *Prefetcher::takeFace(const DirectorySubEntry *jpegDesc) {
+	int i = findFace(jpegDesc);
+	if (i < 0 || !_faces[i].bitmap)
+		return nullptr;
+
+	debugC(kDebugNode, "Using prefetched cube face %d", jpegDesc->getFace());
+
+	Graphics::Surface *bitmap = _faces[i].bitmap;
+	_faces.remove_at(i);
+	return bitmap;
+}
+
+} // End of namespace Myst3
@@ -0,0 +1,88 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef PREFETCHER_H_
+#define PREFETCHER_H_
+
+#include "common/array.h"
+
+namespace Graphics {
+struct Surface;
+}
+
+namespace Myst3 {
+
+class Myst3Engine;
+class DirectorySubEntry;
+
+/**
+ * Decodes ahead of time the cube faces of the nodes the player
+ * is likely to go to next, so that loading them does not hitch.
+ */
+class Prefetcher {
+public:
+	Prefetcher(Myst3Engine *vm);
+	~Prefetcher();
+
+	/**
+	 * Queues the cube faces of the nodes reachable from the
+	 * current node's hotspots, dropping the faces no longer needed
+	 */
+	void predictNextNodes();
+
+	/**
+	 * Decodes one of the queued faces, to be called once per frame
+	 */
+	void update();
+
+	/**
+	 * Returns the decoded bitmap for a face if it was prefetched.
+	 * The ownership of the bitmap is transferred to the caller.
+	 */
+	Graphics::Surface *takeFace(const DirectorySubEntry *jpegDesc);
+
+	/**
+	 * Drops all the prefetched faces, to be called before
+	 * the archive the faces come from is closed
+	 */
+	void clear();
+
+private:
+	struct PrefetchedFace {
+		const DirectorySubEntry *desc;
+		Graphics::Surface *bitmap;
+	};
+
+	// Maximum number of faces kept around, that is two nodes
+	static const uint kMaxFaces = 12;
+
+	Myst3Engine *_vm;
+	Common::Array<PrefetchedFace> _faces;
+
+	void freeFace(PrefetchedFace &face);
+	int findFace(const DirectorySubEntry *jpegDesc) const;
+};
+
+} // End of namespace Myst3
+
+#endif // PREFETCHER_H_
@@ -35,7 +35,8 @@
 namespace Myst3 {
 
 Script::Script(Myst3Engine *vm):
-		_vm(vm) {
+		_vm(vm),
+		_profiling(false) {
 	_puzzles = new Puzzles(_vm);
 
 #define OP_0(op, x) _commands.push_back(Command(op, &Script::x, #x, 0))
@@ -285,6 +286,21 @@ Script::Script(Myst3Engine *vm):
 #undef OP_3
 #undef OP_4
 #undef OP_5
+
+	assert(_commands[0].op == 0);
+	for (uint i = 0; i < ARRAYSIZE(_commandTable); i++)
+		_commandTable[i] = &_commands[0];
+
+	for (uint i = 0; i < _commands.size(); i++) {
+		uint16 op = _commands[i].op;
+		assert(op < ARRAYSIZE(_commandTable));
+
+		// Keep the first registration, as the linear lookup did
+		if (_commandTable[op]->op == 0)
+			_commandTable[op] = &_commands[i];
+	}
+
+	resetOpcodeStats();
 }
 
 Script::~Script() {
@@ -315,21 +331,41 @@ bool Script::run(const Common::Array<Opcode> *script) {
 }
 
 const Script::Command &Script::findCommand(uint16 op) {
-	for (uint16 i = 0; i < _commands.size(); i++)
-		if (_commands[i].op == op)
-			return _commands[i];
-
 	// Return the invalid opcode if not found
-	return findCommand(0);
+	if (op >= ARRAYSIZE(_commandTable))
+		return *_commandTable[0];
+
+	return *_commandTable[op];
 }
 
 void Script::runOp(Context &c, const Opcode &op) {
 	const Script::Command &cmd = findCommand(op.op);
 
-	if (cmd.op != 0)
-		(this->*(cmd.proc))(c, op);
-	else
+	if (cmd.op == 0) {
 		debugC(kDebugScript, "Trying to run invalid opcode %d", op.op);
+		return;
+	}
+
+	if (!_profiling) {
+		(this->*(cmd.proc))(c, op);
+		return;
+	}
+
+	uint32 start = g_system->getMillis();
+	(this->*(cmd.proc))(c, op);
+
+	OpcodeStats &stats = _opcodeStats[op.op];
+	stats.count++;
+	stats.time += g_system->getMillis() - start;
+}
+
+void Script::resetOpcodeStats() {
+	memset(_opcodeStats, 0, sizeof(_opcodeStats));
+}
+
+const char *Script::getOpcodeName(uint8 op) {
+	const Command &cmd = findCommand(op);
+	return cmd.op != 0 ? cmd.desc : nullptr;
 }
 
 void Script::runSingleOp(const Opcode &op) {
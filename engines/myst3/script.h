@@ -43,6 +43,17 @@ public:
 
 	const Common::String describeOpcode(const Opcode &opcode);
 
+	struct OpcodeStats {
+		uint32 count;
+		uint32 time; // In ms, including the scripts run by the opcode
+	};
+
+	void setProfiling(bool enabled) { _profiling = enabled; }
+	bool isProfiling() const { return _profiling; }
+	void resetOpcodeStats();
+	const OpcodeStats &getOpcodeStats(uint8 op) const { return _opcodeStats[op]; }
+	const char *getOpcodeName(uint8 op);
+
 private:
 	struct Context {
 		bool endScript;
@@ -88,6 +99,12 @@ private:
 
 	Common::Array<Command> _commands;
 
+	// Commands indexed by opcode, unknown opcodes point to badOpcode
+	const Command *_commandTable[256];
+
+	bool _profiling;
+	OpcodeStats _opcodeStats[256];
+
 	const Command &findCommand(uint16 op);
 	const Common::String describeCommand(uint16 op);
 	const Common::String describeArgument(ArgumentType type, int16 value);
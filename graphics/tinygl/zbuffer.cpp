@@ -116,6 +116,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 	_alphaTestEnabled = false;
 	_depthTestEnabled = false;
 	_depthFunc = TGL_LESS;
+	_spanKernelsEnabled = true;
 }
 
 FrameBuffer::~FrameBuffer() {
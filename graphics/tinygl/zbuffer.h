@@ -149,6 +149,9 @@ struct FrameBuffer {
 		return false;
 	}
 
+	// Returns the SpanDepthMode matching the current depth test, see ztriangle.cpp.
+	int getSpanDepthMode() const;
+
 	FORCEINLINE bool checkAlphaTest(byte aSrc) {
 		if (!_alphaTestEnabled)
 			return true;
@@ -363,6 +366,11 @@ struct FrameBuffer {
 		this->_depthWrite = enable;
 	}
 
+	// Lets the rasterizer use the vectorized span kernels where they apply; they are on by default.
+	void enableSpanKernels(bool enable) {
+		_spanKernelsEnabled = enable;
+	}
+
 	bool isAlphaBlendingEnabled() const {
 		return _sourceBlendingFactor == TGL_SRC_ALPHA && _destinationBlendingFactor == TGL_ONE_MINUS_SRC_ALPHA;
 	}
@@ -465,6 +473,7 @@ private:
 	int _alphaTestFunc;
 	int _alphaTestRefVal;
 	int _depthFunc;
+	bool _spanKernelsEnabled;
 };
 
 // memory.c
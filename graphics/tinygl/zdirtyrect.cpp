@@ -95,88 +95,190 @@ void tglDisposeResources(TinyGL::GLContext *c) {
 	Graphics::Internal::tglCleanupImages();
 }
 
-void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
-	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
-	typedef Common::List<TinyGL::DirtyRectangle>::iterator RectangleIterator;
+// Above this number of disjoint dirty rectangles the whole screen is redrawn instead.
+// It also has to fit in the bit masks used by the rectangle grid below.
+static const int kMaxDirtyRectangles = 64;
+// Size of the grid used to index dirty rectangles, in cells per side.
+static const int kDirtyRectangleGridSize = 16;
+
+// Adds a rectangle to a set of pairwise disjoint rectangles, merging it with every rectangle it touches.
+// Returns false if the set would grow beyond kMaxDirtyRectangles.
+static bool tglMergeDirtyRectangle(Common::Array<DirtyRectangle> &rectangles, DirtyRectangle rect) {
+	bool merged;
+	do {
+		merged = false;
+		for (uint i = 0; i < rectangles.size(); ) {
+			if (rectangles[i].rectangle.intersects(rect.rectangle)) {
+				rect.rectangle.extend(rectangles[i].rectangle);
+				rect.r = 0;
+				rect.g = 0;
+				rect.b = 255;
+				rectangles[i] = rectangles.back();
+				rectangles.pop_back();
+				merged = true;
+			} else {
+				++i;
+			}
+		}
+	} while (merged);
 
-	Common::List<DirtyRectangle> rectangles;
+	if (rectangles.size() == kMaxDirtyRectangles) {
+		return false;
+	}
+	rectangles.push_back(rect);
+	return true;
+}
 
-	DrawCallIterator itFrame = c->_drawCallsQueue.begin();
-	DrawCallIterator endPrevFrame = c->_previousFrameDrawCallsQueue.end();
+// Above this number of cells the longest common subsequence of two frames is not computed
+// and every draw call between their common prefix and suffix is considered changed.
+static const uint kMaxDrawCallDiffCells = 64 * 1024;
+
+// Matches the draw calls of two frames by their hashes and flags the ones that have no counterpart.
+// The longest common subsequence is used, so that inserting or removing a draw call
+// does not invalidate all of the following ones.
+static void tglDiffDrawCalls(const Common::Array<Graphics::DrawCall *> &previous, const Common::Array<Graphics::DrawCall *> &current,
+                             Common::Array<bool> &previousChanged, Common::Array<bool> &currentChanged) {
+	previousChanged.resize(previous.size());
+	currentChanged.resize(current.size());
+	for (uint i = 0; i < previous.size(); i++)
+		previousChanged[i] = true;
+	for (uint i = 0; i < current.size(); i++)
+		currentChanged[i] = true;
+
+	uint prefix = 0;
+	while (prefix < previous.size() && prefix < current.size() && previous[prefix]->getHash() == current[prefix]->getHash()) {
+		previousChanged[prefix] = false;
+		currentChanged[prefix] = false;
+		prefix++;
+	}
 
-	// Compare draw calls.
-	if (c->_drawCallsQueue.size() > 0) {
-		for (DrawCallIterator itPrevFrame = c->_previousFrameDrawCallsQueue.begin();
-			itPrevFrame != endPrevFrame;
-			++itPrevFrame, ++itFrame) {
-				const Graphics::DrawCall &currentCall = **itFrame;
-				const Graphics::DrawCall &previousCall = **itPrevFrame;
-
-				if (previousCall != currentCall) {
-					while (itPrevFrame != endPrevFrame) {
-						Graphics::DrawCall *dirtyDrawCall = *itPrevFrame;
-						rectangles.push_back(DirtyRectangle(dirtyDrawCall->getDirtyRegion(), 255, 255, 255));
-						++itPrevFrame;
-					}
-					break;
-				}
-		}
+	uint suffix = 0;
+	while (prefix + suffix < previous.size() && prefix + suffix < current.size() &&
+	       previous[previous.size() - 1 - suffix]->getHash() == current[current.size() - 1 - suffix]->getHash()) {
+		previousChanged[previous.size() - 1 - suffix] = false;
+		currentChanged[current.size() - 1 - suffix] = false;
+		suffix++;
 	}
 
-	for ( ; itFrame != c->_drawCallsQueue.end(); ++itFrame) {
-		const Graphics::DrawCall &currentCall = **itFrame;
-		rectangles.push_back(DirtyRectangle(currentCall.getDirtyRegion(), 255, 0, 0));
+	uint n = previous.size() - prefix - suffix;
+	uint m = current.size() - prefix - suffix;
+	if (n == 0 || m == 0 || (n + 1) * (m + 1) > kMaxDrawCallDiffCells)
+		return;
+
+	// lengths[i * (m + 1) + j] is the length of the common subsequence of the remaining calls from i and j.
+	Common::Array<uint16> lengths;
+	lengths.resize((n + 1) * (m + 1));
+	for (uint j = 0; j <= m; j++)
+		lengths[n * (m + 1) + j] = 0;
+	for (int i = n - 1; i >= 0; i--) {
+		lengths[i * (m + 1) + m] = 0;
+		for (int j = m - 1; j >= 0; j--) {
+			if (previous[prefix + i]->getHash() == current[prefix + j]->getHash()) {
+				lengths[i * (m + 1) + j] = lengths[(i + 1) * (m + 1) + j + 1] + 1;
+			} else {
+				lengths[i * (m + 1) + j] = MAX(lengths[(i + 1) * (m + 1) + j], lengths[i * (m + 1) + j + 1]);
+			}
+		}
 	}
 
-	// This loop increases outer rectangle coordinates to favor merging of adjacent rectangles.
-	for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-		(*it).rectangle.right++;
-		(*it).rectangle.bottom++;
+	uint i = 0, j = 0;
+	while (i < n && j < m) {
+		if (previous[prefix + i]->getHash() == current[prefix + j]->getHash()) {
+			previousChanged[prefix + i] = false;
+			currentChanged[prefix + j] = false;
+			i++;
+			j++;
+		} else if (lengths[(i + 1) * (m + 1) + j] >= lengths[i * (m + 1) + j + 1]) {
+			i++;
+		} else {
+			j++;
+		}
 	}
+}
 
-	// Merge coalesce dirty rects.
-	bool restartMerge;
-	do {
-		restartMerge = false;
-		for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-			for (RectangleIterator it2 = rectangles.begin(); it2 != rectangles.end();) {
-				if (it1 != it2) {
-					if ((*it1).rectangle.intersects((*it2).rectangle)) {
-						(*it1).rectangle.extend((*it2).rectangle);
-						it2 = rectangles.erase(it2);
-						restartMerge = true;
-					} else {
-						++it2;
-					}
-				} else {
-					++it2;
-				}
+void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
+	typedef Common::Array<Graphics::DrawCall *>::const_iterator DrawCallIterator;
+
+	Common::Array<DirtyRectangle> rectangles;
+	Common::Rect renderRect(0, 0, c->fb->xsize - 1, c->fb->ysize - 1);
+	bool fullRedraw = false;
+
+	// Compare draw calls.
+	if (c->_drawCallsQueue.size() > 0) {
+		Common::Array<bool> previousChanged, currentChanged;
+		tglDiffDrawCalls(c->_previousFrameDrawCallsQueue, c->_drawCallsQueue, previousChanged, currentChanged);
+
+		for (uint i = 0; i < previousChanged.size() && !fullRedraw; i++) {
+			if (previousChanged[i]) {
+				Common::Rect rect = c->_previousFrameDrawCallsQueue[i]->getDirtyRegion();
+				// Increase outer rectangle coordinates to favor merging of adjacent rectangles.
+				rect.right++;
+				rect.bottom++;
+				fullRedraw = !tglMergeDirtyRectangle(rectangles, DirtyRectangle(rect, 255, 255, 255));
 			}
 		}
-	} while(restartMerge);
 
-	Common::Rect renderRect(0, 0, c->fb->xsize - 1, c->fb->ysize - 1);
+		for (uint i = 0; i < currentChanged.size() && !fullRedraw; i++) {
+			if (currentChanged[i]) {
+				Common::Rect rect = c->_drawCallsQueue[i]->getDirtyRegion();
+				rect.right++;
+				rect.bottom++;
+				fullRedraw = !tglMergeDirtyRectangle(rectangles, DirtyRectangle(rect, 255, 0, 0));
+			}
+		}
+	}
 
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		RectangleIterator it2 = it1;
-		it2++;
-		while (it2 != rectangles.end()) {
-			if ((*it1).rectangle.contains((*it2).rectangle)) {
-				it2 = rectangles.erase(it2);
-			} else {
-				++it2;
+	// Redrawing most of the screen piecewise costs more than redrawing all of it at once.
+	if (!fullRedraw) {
+		int dirtyArea = 0;
+		for (uint i = 0; i < rectangles.size(); i++) {
+			rectangles[i].rectangle.clip(renderRect);
+			dirtyArea += rectangles[i].rectangle.width() * rectangles[i].rectangle.height();
+		}
+		fullRedraw = dirtyArea > renderRect.width() * renderRect.height() * 3 / 4;
+	}
+
+	if (fullRedraw) {
+		rectangles.clear();
+		rectangles.push_back(DirtyRectangle(renderRect, 255, 255, 0));
+	}
+
+	// Index the rectangles in a coarse screen grid, each cell holding a mask of the rectangles touching it.
+	int cellWidth = (c->fb->xsize + kDirtyRectangleGridSize - 1) / kDirtyRectangleGridSize;
+	int cellHeight = (c->fb->ysize + kDirtyRectangleGridSize - 1) / kDirtyRectangleGridSize;
+	uint64 grid[kDirtyRectangleGridSize][kDirtyRectangleGridSize];
+	memset(grid, 0, sizeof(grid));
+
+	for (uint i = 0; i < rectangles.size(); i++) {
+		const Common::Rect &rect = rectangles[i].rectangle;
+		for (int y = rect.top / cellHeight; y <= rect.bottom / cellHeight; y++) {
+			for (int x = rect.left / cellWidth; x <= rect.right / cellWidth; x++) {
+				grid[y][x] |= (uint64)1 << i;
 			}
 		}
-		(*it1).rectangle.clip(renderRect);
 	}
 
 	// Execute draw calls.
 	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
 		Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-		for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-			Common::Rect dirtyRegion = (*itRect).rectangle;
-			if (dirtyRegion.intersects(drawCallRegion) || drawCallRegion.contains(dirtyRegion)) {
-				(*it)->execute(dirtyRegion, true);
+		int left = CLIP<int>(drawCallRegion.left, 0, renderRect.right) / cellWidth;
+		int right = CLIP<int>(drawCallRegion.right, 0, renderRect.right) / cellWidth;
+		int top = CLIP<int>(drawCallRegion.top, 0, renderRect.bottom) / cellHeight;
+		int bottom = CLIP<int>(drawCallRegion.bottom, 0, renderRect.bottom) / cellHeight;
+
+		uint64 candidates = 0;
+		for (int y = top; y <= bottom; y++) {
+			for (int x = left; x <= right; x++) {
+				candidates |= grid[y][x];
+			}
+		}
+
+		for (uint i = 0; candidates != 0; i++, candidates >>= 1) {
+			if (candidates & 1) {
+				const Common::Rect &dirtyRegion = rectangles[i].rectangle;
+				if (dirtyRegion.intersects(drawCallRegion) || drawCallRegion.contains(dirtyRegion)) {
+					(*it)->execute(dirtyRegion, true);
+				}
 			}
 		}
 	}
@@ -191,17 +293,18 @@ void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 
 #if TGL_DIRTY_RECT_SHOW
 	// Draw debug rectangles.
-	// Note: white rectangles are rectangle that contained other rectangles
+	// Note: white rectangles are dirty rects of the previous frame
 	// blue rectangles are rectangle merged from other rectangles
 	// red rectangles are original dirty rects
+	// a yellow rectangle means the whole screen was redrawn
 
 	bool blendingEnabled = c->fb->isBlendingEnabled();
 	bool alphaTestEnabled = c->fb->isAplhaTestEnabled();
 	c->fb->enableBlending(false);
 	c->fb->enableAlphaTest(false);
 
-	for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-		tglDrawRectangle((*it).rectangle, (*it).r, (*it).g, (*it).b);
+	for (uint i = 0; i < rectangles.size(); i++) {
+		tglDrawRectangle(rectangles[i].rectangle, rectangles[i].r, rectangles[i].g, rectangles[i].b);
 	}
 
 	c->fb->enableBlending(blendingEnabled);
@@ -219,7 +322,7 @@ void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 }
 
 void tglPresentBufferSimple(TinyGL::GLContext *c) {
-	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
+	typedef Common::Array<Graphics::DrawCall *>::const_iterator DrawCallIterator;
 
 	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
 		(*it)->execute(true);
@@ -246,6 +349,27 @@ void tglPresentBuffer() {
 
 namespace Graphics {
 
+// 64-bit FNV-1a over 32-bit words; every hashed structure here is made of 4-byte fields.
+static inline uint64 hashData(uint64 hash, const void *data, uint size) {
+	const byte *bytes = (const byte *)data;
+	for (; size >= 4; size -= 4, bytes += 4) {
+		uint32 word;
+		memcpy(&word, bytes, 4);
+		hash = (hash ^ word) * 0x100000001B3ULL;
+	}
+	for (; size > 0; size--, bytes++) {
+		hash = (hash ^ *bytes) * 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+template <typename T>
+static inline uint64 hashValue(uint64 hash, const T &value) {
+	return hashData(hash, &value, sizeof(value));
+}
+
+static const uint64 kHashSeed = 0xCBF29CE484222325ULL;
+
 bool DrawCall::operator==(const DrawCall &other) const {
 	if (_type == other._type) {
 		switch (_type) {
@@ -275,6 +399,60 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	memcpy(_vertex, c->vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
 	_state = captureState();
 	computeDirtyRegion();
+	_hash = computeHash();
+}
+
+uint64 RasterizationDrawCall::computeHash() const {
+	uint64 hash = hashValue(kHashSeed, (int)getType());
+	hash = hashValue(hash, _vertexCount);
+	hash = hashValue(hash, _drawTriangleFront);
+	hash = hashValue(hash, _drawTriangleBack);
+
+	const RasterizationState &state = _state;
+	hash = hashValue(hash, state.beginType);
+	hash = hashValue(hash, state.currentFrontFace);
+	hash = hashValue(hash, state.cullFaceEnabled);
+	hash = hashValue(hash, state.colorMask);
+	hash = hashValue(hash, state.depthTest);
+	hash = hashValue(hash, state.depthFunction);
+	hash = hashValue(hash, state.depthWrite);
+	hash = hashValue(hash, state.shadowMode);
+	hash = hashValue(hash, state.texture2DEnabled);
+	hash = hashValue(hash, state.currentShadeModel);
+	hash = hashValue(hash, state.polygonModeBack);
+	hash = hashValue(hash, state.polygonModeFront);
+	hash = hashValue(hash, state.lightingEnabled);
+	hash = hashValue(hash, state.enableBlending);
+	hash = hashValue(hash, state.sfactor);
+	hash = hashValue(hash, state.dfactor);
+	hash = hashValue(hash, state.depthTestEnabled);
+	hash = hashValue(hash, state.currentColor);
+	hash = hashValue(hash, state.viewportTranslation);
+	hash = hashValue(hash, state.viewportScaling);
+	hash = hashValue(hash, state.alphaTest);
+	hash = hashValue(hash, state.alphaFunc);
+	hash = hashValue(hash, state.alphaRefValue);
+	hash = hashValue(hash, state.texture);
+	hash = hashValue(hash, state.shadowMaskBuf);
+	if (state.texture != nullptr) {
+		hash = hashValue(hash, state.textureVersion);
+	}
+
+	for (int i = 0; i < _vertexCount; i++) {
+		const TinyGL::GLVertex &v = _vertex[i];
+		hash = hashValue(hash, v.edge_flag);
+		hash = hashValue(hash, v.normal);
+		hash = hashValue(hash, v.coord);
+		hash = hashValue(hash, v.tex_coord);
+		hash = hashValue(hash, v.color);
+		hash = hashValue(hash, v.ec);
+		hash = hashValue(hash, v.pc);
+		hash = hashValue(hash, v.clip_code);
+		// sz and tz are scratch values of the rasterizer and are not part of the vertex content.
+		const int zp[] = { v.zp.x, v.zp.y, v.zp.z, v.zp.s, v.zp.t, v.zp.r, v.zp.g, v.zp.b, v.zp.a };
+		hash = hashValue(hash, zp);
+	}
+	return hash;
 }
 
 void RasterizationDrawCall::computeDirtyRegion() {
@@ -552,6 +730,38 @@ bool RasterizationDrawCall::operator==(const RasterizationDrawCall &other) const
 BlittingDrawCall::BlittingDrawCall(Graphics::BlitImage *image, const BlitTransform &transform, BlittingMode blittingMode) : DrawCall(DrawCall_Blitting), _transform(transform), _mode(blittingMode), _image(image) {
 	_blitState = captureState();
 	_imageVersion = tglGetBlitImageVersion(image);
+	_hash = computeHash();
+}
+
+uint64 BlittingDrawCall::computeHash() const {
+	uint64 hash = hashValue(kHashSeed, (int)getType());
+	hash = hashValue(hash, (int)_mode);
+	hash = hashValue(hash, _image);
+	hash = hashValue(hash, _imageVersion);
+
+	const Common::Rect rects[] = { _transform._sourceRectangle, _transform._destinationRectangle };
+	for (int i = 0; i < 2; i++) {
+		const int16 coords[] = { rects[i].left, rects[i].top, rects[i].right, rects[i].bottom };
+		hash = hashValue(hash, coords);
+	}
+	hash = hashValue(hash, _transform._rotation);
+	hash = hashValue(hash, _transform._originX);
+	hash = hashValue(hash, _transform._originY);
+	hash = hashValue(hash, _transform._aTint);
+	hash = hashValue(hash, _transform._rTint);
+	hash = hashValue(hash, _transform._gTint);
+	hash = hashValue(hash, _transform._bTint);
+	hash = hashValue(hash, _transform._flipHorizontally);
+	hash = hashValue(hash, _transform._flipVertically);
+
+	hash = hashValue(hash, _blitState.enableBlending);
+	hash = hashValue(hash, _blitState.sfactor);
+	hash = hashValue(hash, _blitState.dfactor);
+	hash = hashValue(hash, _blitState.alphaTest);
+	hash = hashValue(hash, _blitState.alphaFunc);
+	hash = hashValue(hash, _blitState.alphaRefValue);
+	hash = hashValue(hash, _blitState.depthTestEnabled);
+	return hash;
 }
 
 void BlittingDrawCall::execute(bool restoreState) const {
@@ -639,6 +849,18 @@ bool BlittingDrawCall::operator==(const BlittingDrawCall &other) const {
 
 ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue, bool clearColorBuffer, int rValue, int gValue, int bValue) 
 	: _clearZBuffer(clearZBuffer), _clearColorBuffer(clearColorBuffer), _zValue(zValue), _rValue(rValue), _gValue(gValue), _bValue(bValue), DrawCall(DrawCall_Clear) {
+	_hash = computeHash();
+}
+
+uint64 ClearBufferDrawCall::computeHash() const {
+	uint64 hash = hashValue(kHashSeed, (int)getType());
+	hash = hashValue(hash, _clearZBuffer);
+	hash = hashValue(hash, _clearColorBuffer);
+	hash = hashValue(hash, _rValue);
+	hash = hashValue(hash, _gValue);
+	hash = hashValue(hash, _bValue);
+	hash = hashValue(hash, _zValue);
+	return hash;
 }
 
 void ClearBufferDrawCall::execute(bool restoreState) const {
@@ -54,7 +54,7 @@ public:
 		DrawCall_Clear
 	};
 
-	DrawCall(DrawCallType type) : _type(type) { }
+	DrawCall(DrawCallType type) : _type(type), _hash(0) { }
 	virtual ~DrawCall() { }
 	bool operator==(const DrawCall &other) const;
 	bool operator!=(const DrawCall &other) const {
@@ -63,7 +63,11 @@ public:
 	virtual void execute(bool restoreState) const = 0;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const = 0;
 	DrawCallType getType() const { return _type; }
+	// Content hash computed when the draw call is recorded, used to compare draw calls across frames.
+	uint64 getHash() const { return _hash; }
 	virtual const Common::Rect getDirtyRegion() const = 0;
+protected:
+	uint64 _hash;
 private:
 	DrawCallType _type;
 };
@@ -83,6 +87,7 @@ public:
 
 	void operator delete(void *p) { }
 private:
+	uint64 computeHash() const;
 	bool _clearZBuffer, _clearColorBuffer;
 	int _rValue, _gValue, _bValue, _zValue;
 };
@@ -105,6 +110,7 @@ public:
 private:
 	typedef void (*gl_draw_triangle_func_ptr)(TinyGL::GLContext *c, TinyGL::GLVertex *p0, TinyGL::GLVertex *p1, TinyGL::GLVertex *p2);
 	void computeDirtyRegion();
+	uint64 computeHash() const;
 	Common::Rect _dirtyRegion;
 	int _vertexCount;
 	TinyGL::GLVertex *_vertex;
@@ -195,6 +201,7 @@ private:
 
 	BlittingState captureState() const;
 	void applyState(const BlittingState &state) const;
+	uint64 computeHash() const;
 
 	BlittingState _blitState;
 };
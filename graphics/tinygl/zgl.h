@@ -384,8 +384,8 @@ struct GLContext {
 	Common::List<Graphics::BlitImage *> _blitImages;
 
 	// Draw call queue
-	Common::List<Graphics::DrawCall *> _drawCallsQueue;
-	Common::List<Graphics::DrawCall *> _previousFrameDrawCallsQueue;
+	Common::Array<Graphics::DrawCall *> _drawCallsQueue;
+	Common::Array<Graphics::DrawCall *> _previousFrameDrawCallsQueue;
 	int _currentAllocatorIndex;
 	LinearAllocator _drawCallAllocator[2];
 };
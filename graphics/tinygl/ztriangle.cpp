@@ -30,12 +30,209 @@
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
 
+// Vectorized span kernels are used where the target guarantees the instruction set.
+#if defined(SCUMM_LITTLE_ENDIAN) && defined(__SSE2__)
+#define TINYGL_SIMD_SPANS
+#include <emmintrin.h>
+#elif defined(SCUMM_LITTLE_ENDIAN) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define TINYGL_SIMD_SPANS
+#include <arm_neon.h>
+#endif
+
 namespace TinyGL {
 
 static const int NB_INTERP = 8;
 
 #define SAR_RND_TO_ZERO(v,n) (v / (1 << n))
 
+// Depth tests handled by the span kernels.
+enum SpanDepthMode {
+	kSpanDepthUnsupported,
+	kSpanDepthAlways,
+	kSpanDepthLess,
+	kSpanDepthLessEqual
+};
+
+FORCEINLINE static bool spanDepthPass(int depthMode, unsigned int zSrc, unsigned int zDst) {
+	switch (depthMode) {
+	case kSpanDepthLess:
+		return zDst < zSrc;
+	case kSpanDepthLessEqual:
+		return zDst <= zSrc;
+	default:
+		return true;
+	}
+}
+
+// Constant span color, also used for depth-only spans.
+struct SpanFlatColor {
+	SpanFlatColor(uint32 value) : _value(value) {}
+
+	FORCEINLINE uint32 next() {
+		return _value;
+	}
+
+	uint32 _value;
+};
+
+// Gouraud span color, stepped exactly like putPixelSmooth whether or not the pixel is drawn.
+struct SpanSmoothColor {
+	SpanSmoothColor(const Graphics::PixelFormat &format, unsigned int rgb, unsigned int drgbdx, unsigned int a, unsigned int dadx) :
+		_format(format), _rgb(rgb), _drgbdx(drgbdx), _a(a), _dadx(dadx) {}
+
+	FORCEINLINE uint32 next() {
+		unsigned int tmp = _rgb & 0xF81F07E0;
+		unsigned int color = tmp | (tmp >> 16);
+		uint32 value = _format.ARGBToColor(_a / 256, (color & 0xF800) >> 8, (color & 0x07E0) >> 3, (color & 0x001F) << 3);
+		_a += _dadx;
+		_rgb = (_rgb + _drgbdx) & (~0x00200800);
+		return value;
+	}
+
+	const Graphics::PixelFormat &_format;
+	unsigned int _rgb, _drgbdx, _a, _dadx;
+};
+
+#if defined(TINYGL_SIMD_SPANS) && defined(__SSE2__)
+// Depths of four consecutive pixels. The steps are computed modulo 2^32, like the scalar z += dzdx.
+FORCEINLINE static __m128i spanDepths(unsigned int z, int dzdx) {
+	uint32 step = (uint32)dzdx;
+	return _mm_setr_epi32((int32)z, (int32)(z + step), (int32)(z + step * 2), (int32)(z + step * 3));
+}
+
+FORCEINLINE static __m128i spanDepthMask(int depthMode, __m128i zSrc, __m128i zDst) {
+	// SSE2 only compares signed integers, so both operands are biased by the sign bit.
+	const __m128i signBit = _mm_set1_epi32((int32)0x80000000);
+	if (depthMode == kSpanDepthLess) {
+		return _mm_cmplt_epi32(_mm_xor_si128(zDst, signBit), _mm_xor_si128(zSrc, signBit));
+	} else if (depthMode == kSpanDepthLessEqual) {
+		__m128i mask = _mm_cmpgt_epi32(_mm_xor_si128(zDst, signBit), _mm_xor_si128(zSrc, signBit));
+		return _mm_xor_si128(mask, _mm_set1_epi32(-1));
+	}
+	return _mm_set1_epi32(-1);
+}
+#elif defined(TINYGL_SIMD_SPANS)
+FORCEINLINE static uint32x4_t spanDepths(unsigned int z, int dzdx) {
+	uint32 step = (uint32)dzdx;
+	const uint32 depths[4] = { z, z + step, z + step * 2, z + step * 3 };
+	return vld1q_u32(depths);
+}
+
+FORCEINLINE static uint32x4_t spanDepthMask(int depthMode, uint32x4_t zSrc, uint32x4_t zDst) {
+	if (depthMode == kSpanDepthLess) {
+		return vcltq_u32(zDst, zSrc);
+	} else if (depthMode == kSpanDepthLessEqual) {
+		return vcleq_u32(zDst, zSrc);
+	}
+	return vdupq_n_u32(0xFFFFFFFF);
+}
+#endif
+
+// Returns whether any of the four pixels starting at pz passes the depth test.
+// Textured spans use it to skip groups of hidden pixels without fetching texels.
+FORCEINLINE static bool spanDepthAnyPass(int depthMode, const unsigned int *pz, unsigned int z, int dzdx) {
+#if defined(TINYGL_SIMD_SPANS) && defined(__SSE2__)
+	__m128i mask = spanDepthMask(depthMode, spanDepths(z, dzdx), _mm_loadu_si128((const __m128i *)pz));
+	return _mm_movemask_epi8(mask) != 0;
+#elif defined(TINYGL_SIMD_SPANS)
+	uint32x4_t mask = spanDepthMask(depthMode, spanDepths(z, dzdx), vld1q_u32(pz));
+	uint32x2_t halves = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+	return (vget_lane_u32(halves, 0) | vget_lane_u32(halves, 1)) != 0;
+#else
+	for (int i = 0; i < 4; i++) {
+		if (spanDepthPass(depthMode, z, pz[i]))
+			return true;
+		z += dzdx;
+	}
+	return false;
+#endif
+}
+
+// Fills count pixels of a depth-only, flat or Gouraud span with neither scissor, alpha test nor blending.
+// Matches putPixelDepth, putPixelFlat and putPixelSmooth, four pixels at a time when SIMD is available.
+template <int kBytesPerPixel, bool kWriteColor, bool kDepthWrite, class ColorSource>
+static void fillSpan(int depthMode, byte *pp, unsigned int *pz, unsigned int z, int dzdx, ColorSource &color, int count) {
+	int i = 0;
+#if defined(TINYGL_SIMD_SPANS)
+	uint32 c[4] = { 0, 0, 0, 0 };
+	for (; i + 4 <= count; i += 4) {
+		if (kWriteColor) {
+			c[0] = color.next();
+			c[1] = color.next();
+			c[2] = color.next();
+			c[3] = color.next();
+		}
+#if defined(__SSE2__)
+		__m128i zSrc = spanDepths(z, dzdx);
+		__m128i zDst = _mm_loadu_si128((const __m128i *)(pz + i));
+		__m128i mask = spanDepthMask(depthMode, zSrc, zDst);
+		if (kDepthWrite) {
+			_mm_storeu_si128((__m128i *)(pz + i), _mm_or_si128(_mm_and_si128(mask, zSrc), _mm_andnot_si128(mask, zDst)));
+		}
+		if (kWriteColor && kBytesPerPixel == 2) {
+			__m128i src = _mm_setr_epi16((int16)c[0], (int16)c[1], (int16)c[2], (int16)c[3], 0, 0, 0, 0);
+			__m128i mask16 = _mm_packs_epi32(mask, mask);
+			__m128i dst = _mm_loadl_epi64((const __m128i *)(pp + i * 2));
+			_mm_storel_epi64((__m128i *)(pp + i * 2), _mm_or_si128(_mm_and_si128(mask16, src), _mm_andnot_si128(mask16, dst)));
+		} else if (kWriteColor) {
+			__m128i src = _mm_setr_epi32((int32)c[0], (int32)c[1], (int32)c[2], (int32)c[3]);
+			__m128i dst = _mm_loadu_si128((const __m128i *)(pp + i * 4));
+			_mm_storeu_si128((__m128i *)(pp + i * 4), _mm_or_si128(_mm_and_si128(mask, src), _mm_andnot_si128(mask, dst)));
+		}
+#else
+		uint32x4_t zSrc = spanDepths(z, dzdx);
+		uint32x4_t zDst = vld1q_u32(pz + i);
+		uint32x4_t mask = spanDepthMask(depthMode, zSrc, zDst);
+		if (kDepthWrite) {
+			vst1q_u32(pz + i, vbslq_u32(mask, zSrc, zDst));
+		}
+		if (kWriteColor && kBytesPerPixel == 2) {
+			uint16 *dst = (uint16 *)(pp + i * 2);
+			vst1_u16(dst, vbsl_u16(vmovn_u32(mask), vmovn_u32(vld1q_u32(c)), vld1_u16(dst)));
+		} else if (kWriteColor) {
+			uint32 *dst = (uint32 *)(pp + i * 4);
+			vst1q_u32(dst, vbslq_u32(mask, vld1q_u32(c), vld1q_u32(dst)));
+		}
+#endif
+		z += (uint32)dzdx * 4;
+	}
+#endif
+	for (; i < count; i++) {
+		uint32 value = kWriteColor ? color.next() : 0;
+		if (spanDepthPass(depthMode, z, pz[i])) {
+			if (kWriteColor && kBytesPerPixel == 2) {
+				((uint16 *)pp)[i] = (uint16)value;
+			} else if (kWriteColor) {
+				((uint32 *)pp)[i] = value;
+			}
+			if (kDepthWrite) {
+				pz[i] = z;
+			}
+		}
+		z += dzdx;
+	}
+}
+
+int FrameBuffer::getSpanDepthMode() const {
+	if (!_spanKernelsEnabled)
+		return kSpanDepthUnsupported;
+	if (pbuf.getFormat().bytesPerPixel != 2 && pbuf.getFormat().bytesPerPixel != 4)
+		return kSpanDepthUnsupported;
+	if (!_depthTestEnabled)
+		return kSpanDepthAlways;
+
+	switch (_depthFunc) {
+	case TGL_LESS:
+		return kSpanDepthLess;
+	case TGL_LEQUAL:
+		return kSpanDepthLessEqual;
+	case TGL_ALWAYS:
+		return kSpanDepthAlways;
+	default:
+		return kSpanDepthUnsupported;
+	}
+}
+
 template <bool kDepthWrite, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending>
 FORCEINLINE static void putPixelFlat(FrameBuffer *buffer, int buf, unsigned int *pz, int _a,
                                      unsigned int &z, int color, unsigned int &a, int &dzdx) {
@@ -298,6 +495,21 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		_drgbdx |= ((dbdx / (1 << 7)) << 12) & 0x001FF000;
 	}
 
+#ifdef TINYGL_SIMD_SPANS
+	// Untextured spans go through the span kernels when no per-pixel state is involved.
+	const bool kSpanKernel = kInterpZ && !kEnableScissor && !kAlphaTestEnabled && !kBlendingEnabled && !(kInterpST || kInterpSTZ) &&
+	                         (kDrawLogic == DRAW_DEPTH_ONLY || kDrawLogic == DRAW_FLAT || kDrawLogic == DRAW_SMOOTH);
+	// Textured spans fetch a texel per pixel, so they only use the vector depth test to skip hidden groups.
+	const bool kSpanDepthSkip = kInterpZ && (kInterpST || kInterpSTZ);
+#else
+	const bool kSpanKernel = false;
+	const bool kSpanDepthSkip = false;
+#endif
+	int spanDepthMode = kSpanDepthUnsupported;
+	if (kSpanKernel || kSpanDepthSkip) {
+		spanDepthMode = getSpanDepthMode();
+	}
+
 	for (part = 0; part < 2; part++) {
 		if (part == 0) {
 			if (fz0 > 0) {
@@ -408,7 +620,32 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		while (nb_lines > 0) {
 			nb_lines--;
 			{
-				if (kDrawLogic == DRAW_DEPTH_ONLY ||
+				if (kSpanKernel && spanDepthMode != kSpanDepthUnsupported) {
+					int n = (x2 >> 16) - x1 + 1;
+					if (n > 0) {
+						if (kDrawLogic == DRAW_DEPTH_ONLY) {
+							SpanFlatColor none(0);
+							fillSpan<4, false, kDepthWrite>(spanDepthMode, nullptr, pz1 + x1, z1, dzdx, none, n);
+						} else if (kDrawLogic == DRAW_FLAT) {
+							SpanFlatColor flat(pbuf.getFormat().ARGBToColor(a1 / 256, (color & 0xF800) >> 8, (color & 0x07E0) >> 3, (color & 0x001F) << 3));
+							if (kRGB565Target) {
+								fillSpan<2, true, kDepthWrite>(spanDepthMode, pbuf.getRawBuffer(pp1 + x1), pz1 + x1, z1, dzdx, flat, n);
+							} else {
+								fillSpan<4, true, kDepthWrite>(spanDepthMode, pbuf.getRawBuffer(pp1 + x1), pz1 + x1, z1, dzdx, flat, n);
+							}
+						} else {
+							unsigned int rgb = (r1 << 16) & 0xFFC00000;
+							rgb |= (g1 >> 5) & 0x000007FF;
+							rgb |= (b1 << 5) & 0x001FF000;
+							SpanSmoothColor smooth(pbuf.getFormat(), rgb, _drgbdx, a1, dadx);
+							if (kRGB565Target) {
+								fillSpan<2, true, kDepthWrite>(spanDepthMode, pbuf.getRawBuffer(pp1 + x1), pz1 + x1, z1, dzdx, smooth, n);
+							} else {
+								fillSpan<4, true, kDepthWrite>(spanDepthMode, pbuf.getRawBuffer(pp1 + x1), pz1 + x1, z1, dzdx, smooth, n);
+							}
+						}
+					}
+				} else if (kDrawLogic == DRAW_DEPTH_ONLY ||
 						(kDrawLogic == DRAW_FLAT && !(kInterpST || kInterpSTZ))) {
 					int pp;
 					int n;
@@ -575,6 +812,21 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 							zinv = (float)(1.0 / fz);
 						}
 						for (int _a = 0; _a < 8; _a++) {
+							if ((_a & 3) == 0 && kSpanDepthSkip && (spanDepthMode == kSpanDepthLess || spanDepthMode == kSpanDepthLessEqual) &&
+							    !spanDepthAnyPass(spanDepthMode, pz + _a, z, dzdx)) {
+								// None of the four pixels is drawn, so only step the interpolants as putPixelTextureMappingPerspective would.
+								z += (unsigned int)dzdx * 4;
+								s += (unsigned int)dsdx * 4;
+								t += (unsigned int)dtdx * 4;
+								if (kDrawLogic == DRAW_SMOOTH) {
+									for (int i = 0; i < 4; i++) {
+										a += dadx;
+										rgb = (rgb + drgbdx) & (~0x00200800);
+									}
+								}
+								_a += 3;
+								continue;
+							}
 							putPixelTextureMappingPerspective<kDepthWrite, kInterpRGB, kDrawLogic == DRAW_SMOOTH, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kRGB565Target>(this, buf, textureFormat, texture,
 							                           pz, _a, z, t, s, tmp, rgb, a, dzdx, dsdx, dtdx, drgbdx, dadx);
 						}
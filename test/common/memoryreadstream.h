@@ -2,6 +2,10 @@
 
 #include "common/memstream.h"
 
+struct SharedBlockDeleter {
+	void operator()(byte *ptr) { delete[] ptr; }
+};
+
 class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 	public:
 	void test_seek_set() {
@@ -104,4 +108,28 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_shared_block() {
+		byte *contents = new byte[6];
+		for (int i = 0; i < 6; ++i)
+			contents[i] = i + 1;
+
+		Common::SharedPtr<byte> block(contents, SharedBlockDeleter());
+		Common::SharedMemoryReadStream *first = new Common::SharedMemoryReadStream(block, 1, 2);
+		Common::SharedMemoryReadStream second(block, 3, 3);
+
+		// The block outlives its original owner while streams view it
+		block.reset();
+
+		TS_ASSERT_EQUALS(first->size(), 2);
+		TS_ASSERT_EQUALS(first->readByte(), 2);
+		TS_ASSERT_EQUALS(first->readByte(), 3);
+		first->readByte();
+		TS_ASSERT(first->eos());
+		delete first;
+
+		TS_ASSERT_EQUALS(second.size(), 3);
+		second.seek(-1, SEEK_END);
+		TS_ASSERT_EQUALS(second.readByte(), 6);
+	}
 };
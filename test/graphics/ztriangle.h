@@ -0,0 +1,129 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/tinygl/zbuffer.h"
+
+// Renders the same triangles with and without the vectorized span kernels
+// and checks that the z buffer and color buffer match bit for bit.
+class ZTriangleTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 67,
+		kHeight = 41,
+		kTextureSize = 64,
+		kTriangles = 200
+	};
+
+	enum DrawMode {
+		kDrawDepthOnly,
+		kDrawFlat,
+		kDrawSmooth,
+		kDrawTextured
+	};
+
+	uint32 _seed;
+	Graphics::PixelBuffer _texture;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % max;
+	}
+
+	TinyGL::ZBufferPoint randomPoint() {
+		TinyGL::ZBufferPoint p;
+		p.x = nextRandom(kWidth);
+		p.y = nextRandom(kHeight);
+		p.z = (1 << 14) + nextRandom(1 << 30);
+		p.s = (1 << 13) + nextRandom((kTextureSize - 1) << 14);
+		p.t = (1 << 13) + nextRandom((kTextureSize - 1) << 14);
+		p.r = (1 << 10) + nextRandom((1 << 16) - (2 << 10));
+		p.g = (1 << 9) + nextRandom((1 << 16) - (2 << 9));
+		p.b = (1 << 10) + nextRandom((1 << 16) - (2 << 10));
+		p.a = (1 << 10) + nextRandom((1 << 16) - (2 << 10));
+		p.sz = p.tz = 0.0f;
+		return p;
+	}
+
+	void setupBuffer(TinyGL::FrameBuffer &fb, bool spanKernels, int depthFunc, bool depthTest, bool depthWrite) {
+		fb.enableSpanKernels(spanKernels);
+		fb.enableDepthTest(depthTest);
+		fb.setDepthFunc(depthFunc);
+		fb.enableDepthWrite(depthWrite);
+		fb._textureSize = kTextureSize;
+		fb._textureSizeMask = (kTextureSize - 1) << ZB_POINT_ST_FRAC_BITS;
+		fb.setTexture(_texture);
+		for (int i = 0; i < kWidth * kHeight; i++) {
+			fb.getZBuffer()[i] = nextRandom(1 << 30);
+		}
+		memset(fb.getPixelBuffer(), 0x5A, fb.linesize * kHeight);
+	}
+
+	void drawTriangle(TinyGL::FrameBuffer &fb, DrawMode mode, TinyGL::ZBufferPoint p0, TinyGL::ZBufferPoint p1, TinyGL::ZBufferPoint p2) {
+		switch (mode) {
+		case kDrawDepthOnly:
+			fb.fillTriangleDepthOnly(&p0, &p1, &p2);
+			break;
+		case kDrawFlat:
+			fb.fillTriangleFlat(&p0, &p1, &p2);
+			break;
+		case kDrawSmooth:
+			fb.fillTriangleSmooth(&p0, &p1, &p2);
+			break;
+		case kDrawTextured:
+			fb.fillTriangleTextureMappingPerspectiveSmooth(&p0, &p1, &p2);
+			break;
+		}
+	}
+
+	void compareRender(const Graphics::PixelFormat &format, DrawMode mode, int depthFunc, bool depthTest, bool depthWrite) {
+		TinyGL::FrameBuffer scalar(kWidth, kHeight, Graphics::PixelBuffer(format, nullptr));
+		TinyGL::FrameBuffer spans(kWidth, kHeight, Graphics::PixelBuffer(format, nullptr));
+
+		uint32 seed = _seed;
+		setupBuffer(scalar, false, depthFunc, depthTest, depthWrite);
+		_seed = seed;
+		setupBuffer(spans, true, depthFunc, depthTest, depthWrite);
+
+		for (int i = 0; i < kTriangles; i++) {
+			TinyGL::ZBufferPoint p0 = randomPoint();
+			TinyGL::ZBufferPoint p1 = randomPoint();
+			TinyGL::ZBufferPoint p2 = randomPoint();
+			drawTriangle(scalar, mode, p0, p1, p2);
+			drawTriangle(spans, mode, p0, p1, p2);
+		}
+
+		TS_ASSERT(memcmp(scalar.getZBuffer(), spans.getZBuffer(), kWidth * kHeight * sizeof(unsigned int)) == 0);
+		TS_ASSERT(memcmp(scalar.getPixelBuffer(), spans.getPixelBuffer(), scalar.linesize * kHeight) == 0);
+	}
+
+	void compareFormat(const Graphics::PixelFormat &format) {
+		static const int depthFuncs[] = { TGL_LESS, TGL_LEQUAL, TGL_ALWAYS, TGL_GREATER };
+		for (int mode = kDrawDepthOnly; mode <= kDrawTextured; mode++) {
+			for (int func = 0; func < ARRAYSIZE(depthFuncs); func++) {
+				compareRender(format, (DrawMode)mode, depthFuncs[func], true, true);
+				compareRender(format, (DrawMode)mode, depthFuncs[func], true, false);
+			}
+			compareRender(format, (DrawMode)mode, TGL_LESS, false, false);
+		}
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+		// Texels with zero alpha exercise the skipped pixels of 16 bit targets.
+		_texture.create(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24), kTextureSize * kTextureSize, DisposeAfterUse::YES);
+		for (int i = 0; i < kTextureSize * kTextureSize; i++) {
+			_texture.setPixelAt(i, (i % 7) == 0 ? 0 : nextRandom(0xFFFFFFFF));
+		}
+	}
+
+	void tearDown() {
+		_texture.free();
+	}
+
+	void test_rgb565() {
+		compareFormat(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+
+	void test_argb8888() {
+		compareFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+	}
+};